@@ -52,3 +52,27 @@
 #if !defined(ICE_CPP11_MAPPING)
 #   define ICE_CPP11_MAPPING 1
 #endif
+
+//
+// Enable the coroutine API if the compiler supports C++20 coroutines.
+//
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       define DATASTORM_HAS_COROUTINES
+#   endif
+#endif
+
+//
+// Select the SIMD instruction set of the SampleBatch aggregation kernels from the instruction set targeted by the
+// application (-mavx2, -msse4.2 or /arch:AVX2), the scalar loops are used otherwise or if DATASTORM_NO_SIMD is
+// defined.
+//
+#if !defined(DATASTORM_NO_SIMD)
+#   if defined(__AVX2__)
+#       define DATASTORM_HAS_AVX2
+#       define DATASTORM_HAS_SIMD
+#   elif defined(__SSE4_2__)
+#       define DATASTORM_HAS_SSE42
+#       define DATASTORM_HAS_SIMD
+#   endif
+#endif
@@ -14,7 +14,24 @@
 #include <DataStorm/InternalT.h>
 #include <DataStorm/CtrlCHandler.h>
 
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <limits>
 #include <regex>
+#include <unordered_map>
+
+#if defined(DATASTORM_HAS_AVX2)
+#   include <immintrin.h>
+#elif defined(DATASTORM_HAS_SSE42)
+#   include <nmmintrin.h>
+#endif
+
+#ifdef DATASTORM_HAS_COROUTINES
+#   include <coroutine>
+#   include <optional>
+#   include <type_traits>
+#endif
 
 /**
  * \mainpage %DataStorm API Reference
@@ -193,6 +210,561 @@ operator<<(std::ostream& os, const Sample<K, V, U>& sample)
     return os;
 }
 
+/**
+ * The SampleBatch class stores samples in columns: the values, timestamps, key indexes and events of the samples
+ * are stored in separate contiguous arrays. A reader appends its unread samples to a batch with getAllUnread or
+ * getUnread. The batch is suited for arithmetic or trivially copyable value types: processing the columns
+ * doesn't require to dereference a sample object per sample.
+ *
+ * The aggregate and vwap methods compute the minimum, maximum, sum or volume weighted average price of the
+ * sample values received in a time window, for a key or for each key of the batch. If the application targets
+ * the AVX2 or SSE4.2 instruction sets, the samples are selected by blocks of 4 with SIMD comparisons of the
+ * timestamp, key index and event columns, the methods for a key accumulate the values of each block lane in a
+ * separate partial aggregate with branch-free code. The samples are selected one by one otherwise. The methods
+ * for each key compute all the aggregates with a single pass over the columns. Samples with the Remove event
+ * don't have a value and are not aggregated.
+ *
+ * The buffers of the batch are kept when the batch is cleared, a batch can be reused to read samples without
+ * allocating memory once the buffers are large enough.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+template<typename Key, typename Value> class SampleBatch
+{
+#if defined(__clang__) || !defined(__GNUC__) || ((__GNUC__* 100) + __GNUC_MINOR__) >= 500
+    static_assert(std::is_trivially_copyable<Value>::value, "sample batches require a trivially copyable value");
+#endif
+
+public:
+
+    /**
+     * The key type.
+     */
+    using KeyType = Key;
+
+    /**
+     * The value type.
+     */
+    using ValueType = Value;
+
+    /**
+     * The time point type used to specify the aggregation window.
+     */
+    using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+
+    /**
+     * The result of an aggregation. The minimum and maximum are set to a default value if no values were
+     * aggregated.
+     */
+    template<typename T> struct Aggregate
+    {
+        /** The minimum value. */
+        T min;
+
+        /** The maximum value. */
+        T max;
+
+        /** The sum of the values. */
+        T sum;
+
+        /** The number of aggregated values. */
+        std::size_t count;
+    };
+
+    /** @private */
+    struct Identity
+    {
+        const Value& operator()(const Value& value) const noexcept
+        {
+            return value;
+        }
+    };
+
+    /** @private */
+    template<typename F>
+    using FieldType = typename std::decay<decltype(std::declval<F&>()(std::declval<const Value&>()))>::type;
+
+    /**
+     * Get the number of samples in the batch.
+     *
+     * @return The number of samples.
+     */
+    std::size_t size() const noexcept
+    {
+        return _values.size();
+    }
+
+    /**
+     * Indicates whether or not the batch is empty.
+     *
+     * @return True if the batch has no samples, false otherwise.
+     */
+    bool empty() const noexcept
+    {
+        return _values.empty();
+    }
+
+    /**
+     * Remove the samples and keys from the batch. The memory allocated for the columns is kept.
+     */
+    void clear() noexcept
+    {
+        _values.clear();
+        _timestamps.clear();
+        _keyIndexes.clear();
+        _events.clear();
+        _keys.clear();
+        _keyIds.clear();
+    }
+
+    /**
+     * Get the sample values. The value of a sample with the Remove event is a default value.
+     *
+     * @return The sample values.
+     */
+    const std::vector<Value>& getValues() const noexcept
+    {
+        return _values;
+    }
+
+    /**
+     * Get the sample timestamps, in microseconds since the system clock epoch.
+     *
+     * @return The sample timestamps.
+     */
+    const std::vector<long long int>& getTimeStamps() const noexcept
+    {
+        return _timestamps;
+    }
+
+    /**
+     * Get the sample key indexes. The key of a sample is the element of getKeys at the sample key index.
+     *
+     * @return The sample key indexes.
+     */
+    const std::vector<unsigned int>& getKeyIndexes() const noexcept
+    {
+        return _keyIndexes;
+    }
+
+    /**
+     * Get the sample events.
+     *
+     * @return The sample events.
+     */
+    const std::vector<SampleEvent>& getEvents() const noexcept
+    {
+        return _events;
+    }
+
+    /**
+     * Get the keys of the samples, in the order the keys were first added to the batch.
+     *
+     * @return The keys.
+     */
+    const std::vector<Key>& getKeys() const noexcept
+    {
+        return _keys;
+    }
+
+    /**
+     * Aggregate the values of each key received between the given time points included. The field function
+     * returns the arithmetic value to aggregate from a sample value, it defaults to the sample value.
+     *
+     * @param from The start of the time window.
+     * @param to The end of the time window.
+     * @param field The function returning the value to aggregate.
+     * @return The aggregates, the aggregate of a key is at the key index.
+     */
+    template<typename F = Identity> std::vector<Aggregate<FieldType<F>>>
+    aggregate(TimePoint from = TimePoint::min(), TimePoint to = TimePoint::max(), F field = F()) const
+    {
+        using R = FieldType<F>;
+        auto begin = toMicroseconds(from);
+        auto end = toMicroseconds(to);
+        Aggregate<R> initial = { std::numeric_limits<R>::max(), std::numeric_limits<R>::lowest(), R(), 0 };
+        std::vector<Aggregate<R>> aggregates(_keys.size(), initial);
+        auto size = _values.size();
+        std::size_t i = 0;
+#ifdef DATASTORM_HAS_SIMD
+        for(; i + blockSize <= size; i += blockSize)
+        {
+            auto selected = selectBlock(i, begin, end);
+            for(std::size_t l = 0; selected != 0; ++l, selected >>= 1)
+            {
+                if(selected & 1)
+                {
+                    accumulate(aggregates[_keyIndexes[i + l]], field(_values[i + l]));
+                }
+            }
+        }
+#endif
+        for(; i < size; ++i)
+        {
+            if(isSelected(i, begin, end))
+            {
+                accumulate(aggregates[_keyIndexes[i]], field(_values[i]));
+            }
+        }
+        for(auto& aggregate : aggregates)
+        {
+            if(aggregate.count == 0)
+            {
+                aggregate.min = R();
+                aggregate.max = R();
+            }
+        }
+        return aggregates;
+    }
+
+    /**
+     * Aggregate the values of the given key received between the given time points included. The field
+     * function returns the arithmetic value to aggregate from a sample value, it defaults to the sample value.
+     *
+     * @param key The key index.
+     * @param from The start of the time window.
+     * @param to The end of the time window.
+     * @param field The function returning the value to aggregate.
+     * @return The aggregate.
+     */
+    template<typename F = Identity> Aggregate<FieldType<F>>
+    aggregate(unsigned int key, TimePoint from = TimePoint::min(), TimePoint to = TimePoint::max(),
+              F field = F()) const
+    {
+        using R = FieldType<F>;
+        auto begin = toMicroseconds(from);
+        auto end = toMicroseconds(to);
+
+        //
+        // The samples are accumulated in the partial aggregate of their block lane, this breaks the dependency
+        // between consecutive values. The accumulation is branch-free, the selection of the samples of a key
+        // isn't predictable if the batch has several keys.
+        //
+        Aggregate<R> a0 = { std::numeric_limits<R>::max(), std::numeric_limits<R>::lowest(), R(), 0 };
+        Aggregate<R> a1 = a0;
+        Aggregate<R> a2 = a0;
+        Aggregate<R> a3 = a0;
+        auto size = _values.size();
+        std::size_t i = 0;
+#ifdef DATASTORM_HAS_SIMD
+        for(; i + blockSize <= size; i += blockSize)
+        {
+            auto selected = selectBlock(i, begin, end) & matchKeyBlock(i, key);
+            accumulate(a0, field(_values[i]), selected & 1);
+            accumulate(a1, field(_values[i + 1]), (selected >> 1) & 1);
+            accumulate(a2, field(_values[i + 2]), (selected >> 2) & 1);
+            accumulate(a3, field(_values[i + 3]), (selected >> 3) & 1);
+        }
+#endif
+        for(; i < size; ++i)
+        {
+            accumulate(a0, field(_values[i]), (_keyIndexes[i] == key) & isSelected(i, begin, end));
+        }
+
+        auto& aggregate = a0;
+        for(const auto* partial : { &a1, &a2, &a3 })
+        {
+            aggregate.min = partial->min < aggregate.min ? partial->min : aggregate.min;
+            aggregate.max = partial->max > aggregate.max ? partial->max : aggregate.max;
+            aggregate.sum += partial->sum;
+            aggregate.count += partial->count;
+        }
+        return aggregate.count > 0 ? aggregate : Aggregate<R> { R(), R(), R(), 0 };
+    }
+
+    /**
+     * Compute the volume weighted average price of each key for the samples received between the given time
+     * points included. The price and quantity functions return the price and quantity of a sample value.
+     *
+     * @param price The function returning the price of a sample value.
+     * @param quantity The function returning the quantity of a sample value.
+     * @param from The start of the time window.
+     * @param to The end of the time window.
+     * @return The volume weighted average prices, the price of a key is at the key index. The price is 0 if
+     * the key has no quantity in the time window.
+     */
+    template<typename P, typename Q> std::vector<double>
+    vwap(P price, Q quantity, TimePoint from = TimePoint::min(), TimePoint to = TimePoint::max()) const
+    {
+        auto begin = toMicroseconds(from);
+        auto end = toMicroseconds(to);
+        std::vector<double> amounts(_keys.size(), 0.0);
+        std::vector<double> quantities(_keys.size(), 0.0);
+        auto addSample = [&](std::size_t i)
+        {
+            auto q = static_cast<double>(quantity(_values[i]));
+            amounts[_keyIndexes[i]] += static_cast<double>(price(_values[i])) * q;
+            quantities[_keyIndexes[i]] += q;
+        };
+        auto size = _values.size();
+        std::size_t i = 0;
+#ifdef DATASTORM_HAS_SIMD
+        for(; i + blockSize <= size; i += blockSize)
+        {
+            auto selected = selectBlock(i, begin, end);
+            for(std::size_t l = 0; selected != 0; ++l, selected >>= 1)
+            {
+                if(selected & 1)
+                {
+                    addSample(i + l);
+                }
+            }
+        }
+#endif
+        for(; i < size; ++i)
+        {
+            if(isSelected(i, begin, end))
+            {
+                addSample(i);
+            }
+        }
+        for(std::size_t k = 0; k < amounts.size(); ++k)
+        {
+            amounts[k] = quantities[k] != 0.0 ? amounts[k] / quantities[k] : 0.0;
+        }
+        return amounts;
+    }
+
+    /**
+     * Compute the volume weighted average price of the given key for the samples received between the given
+     * time points included. The price and quantity functions return the price and quantity of a sample value.
+     *
+     * @param key The key index.
+     * @param price The function returning the price of a sample value.
+     * @param quantity The function returning the quantity of a sample value.
+     * @param from The start of the time window.
+     * @param to The end of the time window.
+     * @return The volume weighted average price or 0 if the key has no quantity in the time window.
+     */
+    template<typename P, typename Q> double
+    vwap(unsigned int key, P price, Q quantity, TimePoint from = TimePoint::min(),
+         TimePoint to = TimePoint::max()) const
+    {
+        auto begin = toMicroseconds(from);
+        auto end = toMicroseconds(to);
+        // The samples are accumulated in the partial amounts and quantities of their block lane, see aggregate.
+        double a0 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+        double a3 = 0.0;
+        double q0 = 0.0;
+        double q1 = 0.0;
+        double q2 = 0.0;
+        double q3 = 0.0;
+        auto addSample = [&](double& amount, double& quantitySum, std::size_t j, bool selected)
+        {
+            double q = selected ? static_cast<double>(quantity(_values[j])) : 0.0;
+            amount += selected ? static_cast<double>(price(_values[j])) * q : 0.0;
+            quantitySum += q;
+        };
+        auto size = _values.size();
+        std::size_t i = 0;
+#ifdef DATASTORM_HAS_SIMD
+        for(; i + blockSize <= size; i += blockSize)
+        {
+            auto selected = selectBlock(i, begin, end) & matchKeyBlock(i, key);
+            addSample(a0, q0, i, selected & 1);
+            addSample(a1, q1, i + 1, (selected >> 1) & 1);
+            addSample(a2, q2, i + 2, (selected >> 2) & 1);
+            addSample(a3, q3, i + 3, (selected >> 3) & 1);
+        }
+#endif
+        for(; i < size; ++i)
+        {
+            addSample(a0, q0, i, (_keyIndexes[i] == key) & isSelected(i, begin, end));
+        }
+        double amount = (a0 + a1) + (a2 + a3);
+        double quantitySum = (q0 + q1) + (q2 + q3);
+        return quantitySum != 0.0 ? amount / quantitySum : 0.0;
+    }
+
+    /** @private */
+    template<typename UpdateTag> void
+    add(const std::vector<std::shared_ptr<DataStormI::Sample>>& samples)
+    {
+        auto size = _values.size() + samples.size();
+        _values.reserve(size);
+        _timestamps.reserve(size);
+        _keyIndexes.reserve(size);
+        _events.reserve(size);
+        for(const auto& s : samples)
+        {
+            auto sample = std::static_pointer_cast<DataStormI::SampleT<Key, Value, UpdateTag>>(s);
+            auto p = _keyIds.find(sample->key->getId());
+            if(p == _keyIds.end())
+            {
+                p = _keyIds.emplace(sample->key->getId(), static_cast<unsigned int>(_keys.size())).first;
+                _keys.push_back(sample->getKey());
+            }
+            _values.push_back(sample->getValue());
+            _timestamps.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(sample->timestamp.time_since_epoch()).count());
+            _keyIndexes.push_back(p->second);
+            _events.push_back(sample->event);
+        }
+    }
+
+private:
+
+    static long long int
+    toMicroseconds(TimePoint time) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    }
+
+    bool
+    isSelected(std::size_t i, long long int begin, long long int end) const noexcept
+    {
+        return (_timestamps[i] >= begin) & (_timestamps[i] <= end) & (_events[i] != SampleEvent::Remove);
+    }
+
+#ifdef DATASTORM_HAS_SIMD
+    // The number of samples selected at once by selectBlock and matchKeyBlock
+    static const std::size_t blockSize = 4;
+
+    // Returns the mask of the samples i to i + 3 received in the time window and without the Remove event
+    unsigned int
+    selectBlock(std::size_t i, long long int begin, long long int end) const noexcept
+    {
+        static_assert(sizeof(SampleEvent) == 1, "the sample events must be stored as bytes");
+        int events;
+        std::memcpy(&events, _events.data() + i, sizeof(events));
+        auto removed = _mm_cmpeq_epi8(_mm_cvtsi32_si128(events), _mm_set1_epi8(static_cast<char>(SampleEvent::Remove)));
+        unsigned int mask = ~static_cast<unsigned int>(_mm_movemask_epi8(removed));
+#   if defined(DATASTORM_HAS_AVX2)
+        auto timestamps = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_timestamps.data() + i));
+        auto outside = _mm256_or_si256(_mm256_cmpgt_epi64(_mm256_set1_epi64x(begin), timestamps),
+                                       _mm256_cmpgt_epi64(timestamps, _mm256_set1_epi64x(end)));
+        mask &= ~static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(outside)));
+#   else
+        auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_timestamps.data() + i));
+        auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_timestamps.data() + i + 2));
+        auto b = _mm_set1_epi64x(begin);
+        auto e = _mm_set1_epi64x(end);
+        auto outside = static_cast<unsigned int>(
+            _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(_mm_cmpgt_epi64(b, first), _mm_cmpgt_epi64(first, e)))) |
+            _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(_mm_cmpgt_epi64(b, second), _mm_cmpgt_epi64(second, e))))
+                << 2);
+        mask &= ~outside;
+#   endif
+        return mask & 0xF;
+    }
+
+    // Returns the mask of the samples i to i + 3 with the given key index
+    unsigned int
+    matchKeyBlock(std::size_t i, unsigned int key) const noexcept
+    {
+        auto keyIndexes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_keyIndexes.data() + i));
+        auto match = _mm_cmpeq_epi32(keyIndexes, _mm_set1_epi32(static_cast<int>(key)));
+        return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+    }
+#endif
+
+    template<typename R> static void
+    accumulate(Aggregate<R>& aggregate, R value, bool selected) noexcept
+    {
+        aggregate.min = std::min(aggregate.min, selected ? value : std::numeric_limits<R>::max());
+        aggregate.max = std::max(aggregate.max, selected ? value : std::numeric_limits<R>::lowest());
+        aggregate.sum += selected ? value : R();
+        aggregate.count += selected;
+    }
+
+    template<typename R> static void
+    accumulate(Aggregate<R>& aggregate, R value) noexcept
+    {
+        aggregate.min = value < aggregate.min ? value : aggregate.min;
+        aggregate.max = value > aggregate.max ? value : aggregate.max;
+        aggregate.sum += value;
+        ++aggregate.count;
+    }
+
+    std::vector<Value> _values;
+    std::vector<long long int> _timestamps;
+    std::vector<unsigned int> _keyIndexes;
+    std::vector<SampleEvent> _events;
+    std::vector<Key> _keys;
+    std::unordered_map<long long int, unsigned int> _keyIds;
+};
+
+#ifdef DATASTORM_HAS_COROUTINES
+
+/**
+ * The Awaitable class is returned by the coroutine methods of readers and writers. Awaiting it suspends the
+ * coroutine without blocking the calling thread, the coroutine is resumed by the node callback executor thread
+ * once the wait completes. If the node is shutdown, the resumed coroutine raises NodeShutdownException. If the
+ * reader or writer is destroyed, it raises std::logic_error.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+template<typename T>
+class Awaitable
+{
+    using ValueType = typename std::conditional<std::is_void<T>::value, std::nullptr_t, T>::type;
+
+public:
+
+    /** @private */
+    using Callback = std::function<void(ValueType, std::exception_ptr)>;
+
+    /** @private */
+    explicit Awaitable(std::function<void(Callback)> start) noexcept :
+        _start(std::move(start)),
+        _state(std::make_shared<State>())
+    {
+    }
+
+    /** @private */
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /** @private */
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        //
+        // The callback might resume the coroutine and destroy the awaitable before the start function returns,
+        // the awaitable members must not be used once the wait is started.
+        //
+        auto state = _state;
+        auto start = std::move(_start);
+        state->handle = handle;
+        start([state](ValueType value, std::exception_ptr exception)
+        {
+            state->value.emplace(std::move(value));
+            state->exception = exception;
+            state->handle.resume();
+        });
+    }
+
+    /** @private */
+    T await_resume()
+    {
+        if(_state->exception)
+        {
+            std::rethrow_exception(_state->exception);
+        }
+        if constexpr(!std::is_void<T>::value)
+        {
+            return std::move(*_state->value);
+        }
+    }
+
+private:
+
+    struct State
+    {
+        std::coroutine_handle<> handle;
+        std::optional<ValueType> value;
+        std::exception_ptr exception;
+    };
+
+    std::function<void(Callback)> _start;
+    std::shared_ptr<State> _state;
+};
+
+#endif
+
 /**
  * The Reader class is used to retrieve samples for a data element.
  *
@@ -295,6 +867,82 @@ public:
      */
     Sample<Key, Value, UpdateTag> getNextUnread();
 
+    /**
+     * Returns at most the given number of unread samples. This method doesn't block, it returns an empty vector
+     * if there are no unread samples.
+     *
+     * @param count The maximum number of unread samples to return.
+     * @return The unread samples.
+     */
+    std::vector<Sample<Key, Value, UpdateTag>> getUnread(unsigned int count) noexcept;
+
+    /**
+     * Appends all the unread samples to the given sample batch. The samples are appended to the columns of the
+     * batch instead of being returned as sample objects, see SampleBatch.
+     *
+     * @param batch The batch to append the unread samples to.
+     */
+    void getAllUnread(SampleBatch<Key, Value>& batch) noexcept;
+
+    /**
+     * Appends at most the given number of unread samples to the given sample batch. This method doesn't block,
+     * it doesn't append any samples if there are no unread samples.
+     *
+     * @param count The maximum number of unread samples to append.
+     * @param batch The batch to append the unread samples to.
+     */
+    void getUnread(unsigned int count, SampleBatch<Key, Value>& batch) noexcept;
+
+    /**
+     * Get the notification handle of this reader. The handle is readable while the reader has unread samples,
+     * an application event loop can poll it and consume the unread samples with getUnread or getAllUnread
+     * instead of blocking a thread or using the onSamples callback. The handle is owned by the reader and
+     * must not be closed.
+     *
+     * @return The notification handle.
+     */
+    NotificationHandle getNotificationHandle() const;
+
+#ifdef DATASTORM_HAS_COROUTINES
+    /**
+     * Get an awaitable to wait for the given number of writers to be online. The awaiting coroutine is resumed
+     * by the node callback executor thread. The node shutdown will cause the coroutine to raise
+     * NodeShutdownException.
+     *
+     * @param count The number of writers to wait.
+     * @return The awaitable.
+     */
+    Awaitable<void> writers(unsigned int count = 1) const noexcept;
+
+    /**
+     * Get an awaitable to wait for writers to be offline. The awaiting coroutine is resumed by the node
+     * callback executor thread. The node shutdown will cause the coroutine to raise NodeShutdownException.
+     *
+     * @return The awaitable.
+     */
+    Awaitable<void> noWriters() const noexcept;
+
+    /**
+     * Get an awaitable to wait for the given number of unread samples to be available. The awaiting coroutine
+     * is resumed by the node callback executor thread. The node shutdown will cause the coroutine to raise
+     * NodeShutdownException.
+     *
+     * @param count The number of unread samples to wait.
+     * @return The awaitable.
+     */
+    Awaitable<void> unread(unsigned int count = 1) const noexcept;
+
+    /**
+     * Get an awaitable to wait for the next unread sample. The awaiting coroutine is resumed with the sample by
+     * the node callback executor thread. If several coroutines wait for the next sample, the samples are handed
+     * out in the order the coroutines started waiting. The node shutdown will cause the coroutine to raise
+     * NodeShutdownException.
+     *
+     * @return The awaitable.
+     */
+    Awaitable<Sample<Key, Value, UpdateTag>> nextUnread() noexcept;
+#endif
+
     /**
      * Calls the given functions to provide the initial set of connected keys and when a key is added or
      * removed from the set of connected keys. If callback functions are already set, they will be replaced.
@@ -337,6 +985,20 @@ public:
     void onSamples(std::function<void(std::vector<Sample<Key, Value, UpdateTag>>)> init,
                    std::function<void(Sample<Key, Value, UpdateTag>)> queue) noexcept;
 
+    /**
+     * Returns the latency statistics of the samples queued by this reader since its creation or the last
+     * call to resetLatencyStatistics. Statistics are only collected if enabled with the reader configuration
+     * or the DataStorm.Topic.LatencyStatistics property.
+     *
+     * @return The latency statistics.
+     */
+    LatencyStatistics getLatencyStatistics() const noexcept;
+
+    /**
+     * Reset the latency statistics of this reader.
+     */
+    void resetLatencyStatistics() noexcept;
+
 protected:
 
     /** @private */
@@ -407,6 +1069,26 @@ public:
      */
     void waitForNoReaders() const;
 
+#ifdef DATASTORM_HAS_COROUTINES
+    /**
+     * Get an awaitable to wait for the given number of readers to be online. The awaiting coroutine is resumed
+     * by the node callback executor thread. The node shutdown will cause the coroutine to raise
+     * NodeShutdownException.
+     *
+     * @param count The number of readers to wait.
+     * @return The awaitable.
+     */
+    Awaitable<void> readers(unsigned int count = 1) const noexcept;
+
+    /**
+     * Get an awaitable to wait for readers to be offline. The awaiting coroutine is resumed by the node
+     * callback executor thread. The node shutdown will cause the coroutine to raise NodeShutdownException.
+     *
+     * @return The awaitable.
+     */
+    Awaitable<void> noReaders() const noexcept;
+#endif
+
     /**
      * Get the connected readers.
      *
@@ -435,6 +1117,20 @@ public:
      **/
     std::vector<Sample<Key, Value, UpdateTag>> getAll() noexcept;
 
+    /**
+     * Wait for the samples published by this writer to be sent. If the writer is not asynchronous, the samples
+     * are sent when published and this method returns immediately.
+     **/
+    void flush() const;
+
+    /**
+     * Get a future completed once the samples published by this writer before this call are sent. The future
+     * is also completed if the node is destroyed before the samples are sent.
+     *
+     * @return The future completed once the samples are sent.
+     **/
+    std::future<void> flushAsync() const noexcept;
+
     /**
      * Calls the given functions to provide the initial set of connected keys and when a key is added or
      * removed from the set of connected keys. If callback functions are already set, they will be replaced.
@@ -600,6 +1296,19 @@ public:
      */
     void setReaderDefaultConfig(const ReaderConfig& config) noexcept;
 
+    /**
+     * Returns the latency statistics of the samples queued by the readers of this topic which collect
+     * latency statistics.
+     *
+     * @return The latency statistics.
+     */
+    LatencyStatistics getLatencyStatistics() const noexcept;
+
+    /**
+     * Reset the latency statistics of this topic. The statistics of the readers are not reset.
+     */
+    void resetLatencyStatistics() noexcept;
+
     /**
      * Set an updater function for the given update tag. The function is called when a partial update is
      * received or sent to compute the new value. The function is provided the latest value and the partial
@@ -1021,6 +1730,60 @@ makeFilteredKeyReader(const Topic<K, V, UT>& topic,
     return FilteredKeyReader<K, V, UT>(topic, keyFilter, sampleFilter, name, config);
 }
 
+/**
+ * The composite update class is used to write several partial updates of a data element with a single
+ * {@link PartialUpdate} sample. The partial updates are applied atomically and in order by the writer and the
+ * readers, the sample is added once to the writer history. The sample update tag is the default update tag.
+ *
+ * A composite update is obtained from a writer, the partial updates are added with the add method and the
+ * sample is written with the publish method:
+ *
+ * <pre>
+ * writer.compositeUpdate().add<float>("price", 15.0f).add<float>("lastBid", 14.5f).publish();
+ * </pre>
+ *
+ * Readers apply a composite update with the updaters registered for the tags of its partial updates. Readers
+ * advertise this capability when they attach to the writer, readers of DataStorm versions without composite
+ * updates don't and receive the sample as an {@link Update} with the value computed by the writer. A reader
+ * also receives composite updates as updates if its node disables the DataStorm.Node.CompositeUpdates property.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+template<typename Key, typename Value, typename UpdateTag=std::string>
+class CompositeUpdate
+{
+public:
+
+    /**
+     * Add a partial update to the composite update.
+     *
+     * The UpdateValue template parameter must match the UpdateValue type used to register the updater with
+     * the {@link Topic::setUpdater} method.
+     *
+     * @param tag The partial update tag.
+     * @param value The partial update value.
+     * @return The composite update.
+     */
+    template<typename UpdateValue> CompositeUpdate& add(const UpdateTag& tag, const UpdateValue& value) noexcept;
+
+    /**
+     * Write the partial updates with a single {@link PartialUpdate} sample and clear the composite update.
+     */
+    void publish() noexcept;
+
+    /** @private */
+    CompositeUpdate(const std::shared_ptr<DataStormI::DataWriter>&,
+                    const std::shared_ptr<DataStormI::TagFactoryT<UpdateTag>>&,
+                    const std::shared_ptr<DataStormI::Key>&) noexcept;
+
+private:
+
+    const std::shared_ptr<DataStormI::DataWriter> _impl;
+    const std::shared_ptr<DataStormI::TagFactoryT<UpdateTag>> _tagFactory;
+    const std::shared_ptr<DataStormI::Key> _key;
+    std::vector<std::vector<unsigned char>> _updates;
+};
+
 /**
  * The key writer to write the data element associated with a given key.
  *
@@ -1086,6 +1849,13 @@ public:
      */
     template<typename UpdateValue> std::function<void(const UpdateValue&)> partialUpdate(const UpdateTag& tag) noexcept;
 
+    /**
+     * Get a composite update to write several partial updates with a single {@link PartialUpdate} sample.
+     *
+     * @return The composite update.
+     */
+    CompositeUpdate<Key, Value, UpdateTag> compositeUpdate() noexcept;
+
     /**
      * Remove the data element. This generates a {@link Remove} sample.
      */
@@ -1163,6 +1933,15 @@ public:
     template<typename UpdateValue> std::function<void(const Key&, const UpdateValue&)>
     partialUpdate(const UpdateTag& tag) noexcept;
 
+    /**
+     * Get a composite update to write several partial updates of the given key with a single
+     * {@link PartialUpdate} sample.
+     *
+     * @param key The key
+     * @return The composite update.
+     */
+    CompositeUpdate<Key, Value, UpdateTag> compositeUpdate(const Key& key) noexcept;
+
     /**
      * Remove the data element. This generates a {@link Remove} sample.
 
@@ -1384,6 +2163,98 @@ Reader<Key, Value, UpdateTag>::getNextUnread()
     return Sample<Key, Value, UpdateTag>(_impl->getNextUnread());
 }
 
+template<typename Key, typename Value, typename UpdateTag> std::vector<Sample<Key, Value, UpdateTag>>
+Reader<Key, Value, UpdateTag>::getUnread(unsigned int count) noexcept
+{
+    auto unread = _impl->getUnread(count);
+    std::vector<Sample<Key, Value, UpdateTag>> samples;
+    samples.reserve(unread.size());
+    for(auto sample : unread)
+    {
+        samples.emplace_back(sample);
+    }
+    return samples;
+}
+
+template<typename Key, typename Value, typename UpdateTag> void
+Reader<Key, Value, UpdateTag>::getAllUnread(SampleBatch<Key, Value>& batch) noexcept
+{
+    batch.template add<UpdateTag>(_impl->getAllUnread());
+}
+
+template<typename Key, typename Value, typename UpdateTag> void
+Reader<Key, Value, UpdateTag>::getUnread(unsigned int count, SampleBatch<Key, Value>& batch) noexcept
+{
+    batch.template add<UpdateTag>(_impl->getUnread(count));
+}
+
+template<typename Key, typename Value, typename UpdateTag> NotificationHandle
+Reader<Key, Value, UpdateTag>::getNotificationHandle() const
+{
+    return _impl->getNotificationHandle();
+}
+
+#ifdef DATASTORM_HAS_COROUTINES
+template<typename Key, typename Value, typename UpdateTag> Awaitable<void>
+Reader<Key, Value, UpdateTag>::writers(unsigned int count) const noexcept
+{
+    auto impl = _impl;
+    return Awaitable<void>([impl, count](Awaitable<void>::Callback callback)
+    {
+        impl->waitForListenersAsync(static_cast<int>(count), [callback](std::exception_ptr ex)
+        {
+            callback(nullptr, ex);
+        });
+    });
+}
+
+template<typename Key, typename Value, typename UpdateTag> Awaitable<void>
+Reader<Key, Value, UpdateTag>::noWriters() const noexcept
+{
+    auto impl = _impl;
+    return Awaitable<void>([impl](Awaitable<void>::Callback callback)
+    {
+        impl->waitForListenersAsync(-1, [callback](std::exception_ptr ex) { callback(nullptr, ex); });
+    });
+}
+
+template<typename Key, typename Value, typename UpdateTag> Awaitable<void>
+Reader<Key, Value, UpdateTag>::unread(unsigned int count) const noexcept
+{
+    auto impl = _impl;
+    return Awaitable<void>([impl, count](Awaitable<void>::Callback callback)
+    {
+        impl->waitForUnreadAsync(count, [callback](std::exception_ptr ex) { callback(nullptr, ex); });
+    });
+}
+
+template<typename Key, typename Value, typename UpdateTag> Awaitable<Sample<Key, Value, UpdateTag>>
+Reader<Key, Value, UpdateTag>::nextUnread() noexcept
+{
+    using AwaitableType = Awaitable<Sample<Key, Value, UpdateTag>>;
+    auto impl = _impl;
+    return AwaitableType([impl](typename AwaitableType::Callback callback)
+    {
+        impl->getNextUnreadAsync([callback](std::shared_ptr<DataStormI::Sample> sample, std::exception_ptr ex)
+        {
+            callback(Sample<Key, Value, UpdateTag>(sample), ex);
+        });
+    });
+}
+#endif
+
+template<typename Key, typename Value, typename UpdateTag> LatencyStatistics
+Reader<Key, Value, UpdateTag>::getLatencyStatistics() const noexcept
+{
+    return _impl->getLatencyStatistics();
+}
+
+template<typename Key, typename Value, typename UpdateTag> void
+Reader<Key, Value, UpdateTag>::resetLatencyStatistics() noexcept
+{
+    _impl->resetLatencyStatistics();
+}
+
 template<typename Key, typename Value, typename UpdateTag> void
 Reader<Key, Value, UpdateTag>::onConnectedKeys(std::function<void(std::vector<Key>)> init,
                                                std::function<void(CallbackReason, Key)> update) noexcept
@@ -1596,6 +2467,31 @@ Writer<Key, Value, UpdateTag>::waitForNoReaders() const
     return _impl->waitForReaders(-1);
 }
 
+#ifdef DATASTORM_HAS_COROUTINES
+template<typename Key, typename Value, typename UpdateTag> Awaitable<void>
+Writer<Key, Value, UpdateTag>::readers(unsigned int count) const noexcept
+{
+    auto impl = _impl;
+    return Awaitable<void>([impl, count](Awaitable<void>::Callback callback)
+    {
+        impl->waitForListenersAsync(static_cast<int>(count), [callback](std::exception_ptr ex)
+        {
+            callback(nullptr, ex);
+        });
+    });
+}
+
+template<typename Key, typename Value, typename UpdateTag> Awaitable<void>
+Writer<Key, Value, UpdateTag>::noReaders() const noexcept
+{
+    auto impl = _impl;
+    return Awaitable<void>([impl](Awaitable<void>::Callback callback)
+    {
+        impl->waitForListenersAsync(-1, [callback](std::exception_ptr ex) { callback(nullptr, ex); });
+    });
+}
+#endif
+
 template<typename Key, typename Value, typename UpdateTag> std::vector<std::string>
 Writer<Key, Value, UpdateTag>::getConnectedReaders() const noexcept
 {
@@ -1639,6 +2535,21 @@ Writer<Key, Value, UpdateTag>::getAll() noexcept
     return samples;
 }
 
+template<typename Key, typename Value, typename UpdateTag> void
+Writer<Key, Value, UpdateTag>::flush() const
+{
+    flushAsync().get();
+}
+
+template<typename Key, typename Value, typename UpdateTag> std::future<void>
+Writer<Key, Value, UpdateTag>::flushAsync() const noexcept
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    _impl->flush([promise] { promise->set_value(); });
+    return future;
+}
+
 template<typename Key, typename Value, typename UpdateTag> void
 Writer<Key, Value, UpdateTag>::onConnectedKeys(std::function<void(std::vector<Key>)> init,
                                                std::function<void(CallbackReason, Key)> update) noexcept
@@ -1666,6 +2577,37 @@ Writer<Key, Value, UpdateTag>::onConnectedReaders(std::function<void(std::vector
     _impl->onConnectedElements(init, update);
 }
 
+template<typename Key, typename Value, typename UpdateTag>
+CompositeUpdate<Key, Value, UpdateTag>::CompositeUpdate(const std::shared_ptr<DataStormI::DataWriter>& impl,
+                                                        const std::shared_ptr<DataStormI::TagFactoryT<UpdateTag>>& tags,
+                                                        const std::shared_ptr<DataStormI::Key>& key) noexcept :
+    _impl(impl),
+    _tagFactory(tags),
+    _key(key)
+{
+}
+
+template<typename Key, typename Value, typename UpdateTag>
+template<typename UpdateValue> CompositeUpdate<Key, Value, UpdateTag>&
+CompositeUpdate<Key, Value, UpdateTag>::add(const UpdateTag& tag, const UpdateValue& value) noexcept
+{
+    // The tags are encoded with their value, the readers decode them with the topic tag factory.
+    _updates.push_back(_tagFactory->create(tag)->encode(_impl->getCommunicator()));
+    _updates.push_back(Encoder<UpdateValue>::encode(_impl->getCommunicator(), value));
+    return *this;
+}
+
+template<typename Key, typename Value, typename UpdateTag> void
+CompositeUpdate<Key, Value, UpdateTag>::publish() noexcept
+{
+    std::vector<unsigned char> encoded;
+    Ice::OutputStream stream(_impl->getCommunicator());
+    stream.write(_updates);
+    stream.finished(encoded);
+    _updates.clear();
+    _impl->publish(_key, std::make_shared<DataStormI::SampleT<Key, Value, UpdateTag>>(encoded, nullptr));
+}
+
 template<typename Key, typename Value, typename UpdateTag>
 SingleKeyWriter<Key, Value, UpdateTag>::SingleKeyWriter(const Topic<Key, Value, UpdateTag>& topic,
                                                         const Key& key,
@@ -1718,6 +2660,12 @@ SingleKeyWriter<Key, Value, UpdateTag>::partialUpdate(const UpdateTag& tag) noex
     };
 }
 
+template<typename Key, typename Value, typename UpdateTag> CompositeUpdate<Key, Value, UpdateTag>
+SingleKeyWriter<Key, Value, UpdateTag>::compositeUpdate() noexcept
+{
+    return CompositeUpdate<Key, Value, UpdateTag>(Writer<Key, Value, UpdateTag>::_impl, _tagFactory, nullptr);
+}
+
 template<typename Key, typename Value, typename UpdateTag> void
 SingleKeyWriter<Key, Value, UpdateTag>::remove() noexcept
 {
@@ -1781,6 +2729,14 @@ MultiKeyWriter<Key, Value, UpdateTag>::partialUpdate(const UpdateTag& tag) noexc
     };
 }
 
+template<typename Key, typename Value, typename UpdateTag> CompositeUpdate<Key, Value, UpdateTag>
+MultiKeyWriter<Key, Value, UpdateTag>::compositeUpdate(const Key& key) noexcept
+{
+    return CompositeUpdate<Key, Value, UpdateTag>(Writer<Key, Value, UpdateTag>::_impl,
+                                                  _tagFactory,
+                                                  _keyFactory->create(key));
+}
+
 template<typename Key, typename Value, typename UpdateTag> void
 MultiKeyWriter<Key, Value, UpdateTag>::remove(const Key& key) noexcept
 {
@@ -1976,6 +2932,18 @@ Topic<Key, Value, UpdateTag>::setReaderDefaultConfig(const ReaderConfig& config)
     getReader()->setDefaultConfig(config);
 }
 
+template<typename Key, typename Value, typename UpdateTag> LatencyStatistics
+Topic<Key, Value, UpdateTag>::getLatencyStatistics() const noexcept
+{
+    return getReader()->getLatencyStatistics();
+}
+
+template<typename Key, typename Value, typename UpdateTag> void
+Topic<Key, Value, UpdateTag>::resetLatencyStatistics() noexcept
+{
+    getReader()->resetLatencyStatistics();
+}
+
 template<typename Key, typename Value, typename UpdateTag> bool
 Topic<Key, Value, UpdateTag>::hasReaders() const noexcept
 {
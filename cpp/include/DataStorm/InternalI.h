@@ -74,11 +74,13 @@ public:
            long long int timestamp) :
         session(session), origin(origin), id(id), event(event), key(key), tag(tag),
         timestamp(std::chrono::microseconds(timestamp)),
-        _encodedValue(std::move(value))
+        _encodedValue(std::move(value)),
+        _fullValueEncoded(false)
     {
     }
 
-    Sample(DataStorm::SampleEvent event, const std::shared_ptr<Tag>& tag = nullptr) : event(event), tag(tag)
+    Sample(DataStorm::SampleEvent event, const std::shared_ptr<Tag>& tag = nullptr) :
+        event(event), tag(tag), _fullValueEncoded(false)
     {
     }
 
@@ -94,6 +96,21 @@ public:
         return _encodedValue;
     }
 
+    //
+    // The encoded full value of a partial update sample, sent by writers as a full update to the readers for which
+    // the history starts with this sample. It's encoded once and only accessed with the topic mutex locked, the
+    // flag is required as a value might be encoded to zero bytes.
+    //
+    const std::vector<unsigned char>& encodeFullValue(const std::shared_ptr<Ice::Communicator>& communicator)
+    {
+        if(!_fullValueEncoded)
+        {
+            _encodedFullValue = encodeValue(communicator);
+            _fullValueEncoded = true;
+        }
+        return _encodedFullValue;
+    }
+
     std::string session;
     std::string origin;
     long long int id;
@@ -105,6 +122,8 @@ public:
 protected:
 
     std::vector<unsigned char> _encodedValue;
+    std::vector<unsigned char> _encodedFullValue;
+    bool _fullValueEncoded;
 };
 
 class SampleFactory
@@ -168,6 +187,8 @@ public:
     virtual void onConnectedElements(std::function<void(std::vector<std::string>)>,
                                      std::function<void(DataStorm::CallbackReason, std::string)>) = 0;
 
+    virtual void waitForListenersAsync(int, std::function<void(std::exception_ptr)>) = 0;
+
     virtual void destroy() = 0;
     virtual std::shared_ptr<Ice::Communicator> getCommunicator() const = 0;
 };
@@ -184,9 +205,16 @@ public:
     virtual void waitForUnread(unsigned int) const = 0;
     virtual bool hasUnread() const = 0;
     virtual std::shared_ptr<Sample> getNextUnread() = 0;
+    virtual std::vector<std::shared_ptr<Sample>> getUnread(unsigned int) = 0;
+    virtual DataStorm::NotificationHandle getNotificationHandle() = 0;
+    virtual void waitForUnreadAsync(unsigned int, std::function<void(std::exception_ptr)>) = 0;
+    virtual void getNextUnreadAsync(std::function<void(std::shared_ptr<Sample>, std::exception_ptr)>) = 0;
 
     virtual void onSamples(std::function<void(const std::vector<std::shared_ptr<Sample>>&)>,
                            std::function<void(const std::shared_ptr<Sample>&)>) = 0;
+
+    virtual DataStorm::LatencyStatistics getLatencyStatistics() const = 0;
+    virtual void resetLatencyStatistics() = 0;
 };
 
 class DataWriter : virtual public DataElement
@@ -200,6 +228,7 @@ public:
     virtual std::vector<std::shared_ptr<Sample>> getAll() const = 0;
 
     virtual void publish(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&) = 0;
+    virtual void flush(std::function<void()>) = 0;
 };
 
 class Topic
@@ -240,6 +269,9 @@ public:
     virtual void setDefaultConfig(DataStorm::ReaderConfig) = 0;
     virtual bool hasWriters() const = 0;
     virtual void waitForWriters(int) const = 0;
+
+    virtual DataStorm::LatencyStatistics getLatencyStatistics() const = 0;
+    virtual void resetLatencyStatistics() = 0;
 };
 
 class TopicWriter : virtual public Topic
@@ -369,7 +369,10 @@ public:
     {
     }
 
-    SampleT(DataStorm::SampleEvent event, Value value) : Sample(event), _hasValue(true), _value(std::move(value))
+    SampleT(DataStorm::SampleEvent event, Value value) :
+        Sample(event),
+        _hasValue(true),
+        _value(std::make_shared<Value>(std::move(value)))
     {
     }
 
@@ -395,7 +398,8 @@ public:
 
     const Value& getValue() const
     {
-        return _value;
+        static const Value defaultValue = Value();
+        return _value ? *_value : defaultValue;
     }
 
     UpdateTag getTag() const
@@ -405,7 +409,7 @@ public:
 
     void setValue(Value value)
     {
-        _value = std::move(value);
+        _value = std::make_shared<Value>(std::move(value));
         _hasValue = true;
     }
 
@@ -416,14 +420,17 @@ public:
 
     virtual void setValue(const std::shared_ptr<Sample>& sample) override
     {
+        //
+        // Sample values are immutable once set, the value of the previous sample is shared rather than cloned. A
+        // null value is the default value.
+        //
         if(sample)
         {
-            _value = DataStorm::Cloner<Value>::clone(
-                std::static_pointer_cast<DataStormI::SampleT<Key, Value, UpdateTag>>(sample)->getValue());
+            _value = std::static_pointer_cast<DataStormI::SampleT<Key, Value, UpdateTag>>(sample)->_value;
         }
         else
         {
-            _value = Value();
+            _value = nullptr;
         }
         _hasValue = true;
     }
@@ -440,7 +447,7 @@ public:
     virtual std::vector<unsigned char> encodeValue(const std::shared_ptr<Ice::Communicator>& communicator) override
     {
         assert(_hasValue || event == DataStorm::SampleEvent::Remove);
-        return EncoderT<Value>::encode(communicator, _value);
+        return EncoderT<Value>::encode(communicator, getValue());
     }
 
     virtual void decode(const std::shared_ptr<Ice::Communicator>& communicator) override
@@ -448,7 +455,7 @@ public:
         if(!_encodedValue.empty())
         {
             _hasValue = true;
-            _value = DecoderT<Value>::decode(communicator, _encodedValue);
+            _value = std::make_shared<Value>(DecoderT<Value>::decode(communicator, _encodedValue));
             _encodedValue.clear();
         }
     }
@@ -456,7 +463,7 @@ public:
 private:
 
     bool _hasValue;
-    Value _value;
+    std::shared_ptr<const Value> _value;
 };
 
 template<typename Key, typename Value, typename UpdateTag> class SampleFactoryT : public SampleFactory
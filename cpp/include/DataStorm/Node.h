@@ -5,6 +5,7 @@
 
 #include <DataStorm/Config.h>
 #include <DataStorm/InternalI.h>
+#include <DataStorm/Metrics.h>
 
 namespace DataStorm
 {
@@ -192,6 +193,14 @@ public:
      */
     std::shared_ptr<Ice::Connection> getSessionConnection(const std::string& ident) const noexcept;
 
+    /**
+     * Returns the metrics of the node topics, data elements and sessions. The metrics are also provided by the
+     * DataStorm.Metrics facet of the Ice admin object.
+     *
+     * @return The node metrics.
+     */
+    NodeMetrics getMetrics() const noexcept;
+
 private:
 
     template<typename V, class... T> void init(int& argc, V argv, T&&... iceArgs)
@@ -8,6 +8,12 @@
 #include <Ice/Communicator.h>
 #include <Ice/Optional.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+
 namespace DataStorm
 {
 
@@ -30,7 +36,50 @@ enum struct DiscardPolicy
      * Samples are discarded based on the writer priority. Only samples from the highest priority connected
      * writers are kept, others are discarded.
      */
-    Priority
+    Priority,
+
+    /**
+     * At most one unread sample is kept for each key. A received sample replaces the unread sample of its key
+     * at the same position in the queue of unread samples, the reader only sees the latest state of each key
+     * and the number of unread samples is bounded by the number of keys.
+     */
+    KeepLatestPerKey
+};
+
+/**
+ * The flow control policy specifies what writers do when a reader with unread sample limits has no more credit,
+ * that is when the reader can't queue more samples until the application reads some of its unread samples.
+ */
+enum struct FlowControlPolicy
+{
+    /** The samples are not sent to the reader without credit, the reader misses these samples. */
+    Drop,
+
+    /**
+     * Publishing a sample blocks until every reader without credit interested in the sample grants credit again
+     * or disconnects.
+     */
+    Block
+};
+
+/**
+ * The slow consumer policy specifies what writers do with the samples for a reader session whose connection
+ * doesn't keep up, that is when the samples queued for the session and not yet sent exceed the writer backlog
+ * limits.
+ */
+enum struct SlowConsumerPolicy
+{
+    /** The samples are not sent to the slow session until its backlog is below the limits again. */
+    Drop,
+
+    /**
+     * Only the latest sample of each key is kept for the slow session, it's sent once the backlog is below the
+     * limits again. Add and Remove samples are always sent.
+     */
+    Conflate,
+
+    /** The connection of the slow session is closed, the session is re-established once the peer reconnects. */
+    Disconnect
 };
 
 /**
@@ -122,13 +171,25 @@ public:
      * @param sampleLifetime The optional sample lifetime.
      * @param clearHistory The optional clear history policy.
      * @param discardPolicy The discard policy.
+     * @param latencyStatistics Whether or not latency statistics are collected.
+     * @param maxUpdateRate The optional maximum update rate.
+     * @param maxUnreadSamples The optional maximum number of unread samples.
+     * @param maxUnreadBytes The optional maximum size in bytes of the unread samples.
      */
     ReaderConfig(Ice::optional<int> sampleCount = Ice::nullopt,
                  Ice::optional<int> sampleLifetime = Ice::nullopt,
                  Ice::optional<ClearHistoryPolicy> clearHistory = Ice::nullopt,
-                 Ice::optional<DiscardPolicy> discardPolicy = Ice::nullopt) noexcept :
+                 Ice::optional<DiscardPolicy> discardPolicy = Ice::nullopt,
+                 Ice::optional<bool> latencyStatistics = Ice::nullopt,
+                 Ice::optional<int> maxUpdateRate = Ice::nullopt,
+                 Ice::optional<int> maxUnreadSamples = Ice::nullopt,
+                 Ice::optional<long long int> maxUnreadBytes = Ice::nullopt) noexcept :
         Config(std::move(sampleCount), std::move(sampleLifetime), std::move(clearHistory)),
-        discardPolicy(std::move(discardPolicy))
+        discardPolicy(std::move(discardPolicy)),
+        latencyStatistics(std::move(latencyStatistics)),
+        maxUpdateRate(std::move(maxUpdateRate)),
+        maxUnreadSamples(std::move(maxUnreadSamples)),
+        maxUnreadBytes(std::move(maxUnreadBytes))
     {
     }
 
@@ -136,6 +197,70 @@ public:
      * Specifies if and how samples are discarded after being received by a reader.
      */
     Ice::optional<DiscardPolicy> discardPolicy;
+
+    /**
+     * Specifies whether or not the reader records the latency of the queued samples. The latency is the
+     * difference between the reception time and the writer timestamp of the sample. By default, latency
+     * statistics are not collected.
+     */
+    Ice::optional<bool> latencyStatistics;
+
+    /**
+     * The maximum number of samples per second and per key that writers send to the reader. When set, writers
+     * conflate the samples published faster than this rate: only the latest sample of a key is sent once per
+     * update interval, the intermediate samples are not sent to the reader. Add and Remove samples are always
+     * sent right away and a partial update sent at the end of an interval is sent as a full update. By default,
+     * the update rate isn't limited.
+     */
+    Ice::optional<int> maxUpdateRate;
+
+    /**
+     * The maximum number of unread samples queued by the reader. Writers only send samples to the reader while
+     * it has credit, the reader grants credit as the application reads its unread samples. If the limit is
+     * still reached, the oldest unread samples are discarded. By default, the number of unread samples isn't
+     * limited.
+     */
+    Ice::optional<int> maxUnreadSamples;
+
+    /**
+     * The maximum size in bytes of the unread samples queued by the reader. The size of the unread samples is
+     * estimated from the average encoded size of the received samples, the limit is enforced like the
+     * maxUnreadSamples limit. By default, the size of the unread samples isn't limited.
+     */
+    Ice::optional<long long int> maxUnreadBytes;
+};
+
+/**
+ * The LatencyStatistics structure provides the latency distribution of the samples queued by readers. The
+ * latencies are recorded in a histogram with a relative precision of about 1.5%.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+struct LatencyStatistics
+{
+    /** The number of recorded samples. */
+    long long int count = 0;
+
+    /** The minimum latency. */
+    std::chrono::microseconds min = std::chrono::microseconds::zero();
+
+    /** The maximum latency. */
+    std::chrono::microseconds max = std::chrono::microseconds::zero();
+
+    /** The mean latency. */
+    std::chrono::microseconds mean = std::chrono::microseconds::zero();
+
+    /** The 50th percentile latency. */
+    std::chrono::microseconds p50 = std::chrono::microseconds::zero();
+
+    /** The 90th percentile latency. */
+    std::chrono::microseconds p90 = std::chrono::microseconds::zero();
+
+    /** The 99th percentile latency. */
+    std::chrono::microseconds p99 = std::chrono::microseconds::zero();
+
+    /** The 99.9th percentile latency. */
+    std::chrono::microseconds p999 = std::chrono::microseconds::zero();
 };
 
 /**
@@ -159,13 +284,40 @@ public:
      * @param sampleLifetime The optional sample lifetime.
      * @param clearHistory The optional clear history policy.
      * @param priority The writer priority.
+     * @param async Whether or not the writer publishes samples asynchronously.
+     * @param flowControlPolicy The optional flow control policy.
+     * @param maxBacklogSamples The optional maximum number of samples queued for a reader session.
+     * @param maxBacklogBytes The optional maximum number of bytes queued for a reader session.
+     * @param slowConsumerPolicy The optional slow consumer policy.
+     * @param batch Whether or not the samples are sent with batch requests.
+     * @param batchSize The optional size in bytes of the batched samples that triggers a flush.
+     * @param batchFlushInterval The optional interval in milliseconds at which the batched samples are flushed.
+     * @param lane The optional lane of the connections used to send the samples.
      */
     WriterConfig(Ice::optional<int> sampleCount = Ice::nullopt,
                  Ice::optional<int> sampleLifetime  = Ice::nullopt,
                  Ice::optional<ClearHistoryPolicy> clearHistory = Ice::nullopt,
-                 Ice::optional<int> priority = Ice::nullopt) noexcept :
+                 Ice::optional<int> priority = Ice::nullopt,
+                 Ice::optional<bool> async = Ice::nullopt,
+                 Ice::optional<FlowControlPolicy> flowControlPolicy = Ice::nullopt,
+                 Ice::optional<int> maxBacklogSamples = Ice::nullopt,
+                 Ice::optional<long long int> maxBacklogBytes = Ice::nullopt,
+                 Ice::optional<SlowConsumerPolicy> slowConsumerPolicy = Ice::nullopt,
+                 Ice::optional<bool> batch = Ice::nullopt,
+                 Ice::optional<int> batchSize = Ice::nullopt,
+                 Ice::optional<int> batchFlushInterval = Ice::nullopt,
+                 Ice::optional<int> lane = Ice::nullopt) noexcept :
         Config(std::move(sampleCount), std::move(sampleLifetime), std::move(clearHistory)),
-        priority(std::move(priority))
+        priority(std::move(priority)),
+        async(std::move(async)),
+        flowControlPolicy(std::move(flowControlPolicy)),
+        maxBacklogSamples(std::move(maxBacklogSamples)),
+        maxBacklogBytes(std::move(maxBacklogBytes)),
+        slowConsumerPolicy(std::move(slowConsumerPolicy)),
+        batch(std::move(batch)),
+        batchSize(std::move(batchSize)),
+        batchFlushInterval(std::move(batchFlushInterval)),
+        lane(std::move(lane))
     {
     }
 
@@ -173,8 +325,80 @@ public:
      * Specifies the writer priority. The priority is used by readers using the priority discard policy.
      */
     Ice::optional<int> priority;
+
+    /**
+     * Specifies whether or not the writer publishes samples asynchronously. An asynchronous writer queues the
+     * samples and returns immediately, the samples are encoded, added to the writer history and sent to the
+     * readers by the node sender threads. The number of sender threads is configured with the
+     * DataStorm.Node.Sender.ThreadCount property. By default, samples are published synchronously.
+     */
+    Ice::optional<bool> async;
+
+    /**
+     * Specifies what the writer does with the samples for readers with unread sample limits that have no more
+     * credit. By default, the samples are dropped for these readers.
+     */
+    Ice::optional<FlowControlPolicy> flowControlPolicy;
+
+    /**
+     * The maximum number of samples sent by the writer to a reader session and not yet written to the session
+     * connection. A session above this limit is a slow consumer, its samples are handled according to the slow
+     * consumer policy. By default, the backlog isn't limited.
+     */
+    Ice::optional<int> maxBacklogSamples;
+
+    /**
+     * The maximum number of bytes sent by the writer to a reader session and not yet written to the session
+     * connection. By default, the backlog isn't limited.
+     */
+    Ice::optional<long long int> maxBacklogBytes;
+
+    /**
+     * Specifies what the writer does with the samples for slow consumers. By default, the samples are dropped.
+     */
+    Ice::optional<SlowConsumerPolicy> slowConsumerPolicy;
+
+    /**
+     * Specifies whether or not the writer sends the samples with batch oneway requests. The batched samples are
+     * flushed once their size reaches the batch size, when the batch flush interval elapsed, at the end of each
+     * burst of samples published by an asynchronous writer and when the writer is flushed. Batching reduces the
+     * number of messages and system calls for writers publishing many small samples at the expense of latency.
+     * By default, each sample is sent with its own oneway request.
+     */
+    Ice::optional<bool> batch;
+
+    /**
+     * The size in bytes of the batched samples that triggers a flush. The default is 64KB.
+     */
+    Ice::optional<int> batchSize;
+
+    /**
+     * The maximum amount of time in milliseconds a sample stays in the batch before it's flushed. The default
+     * is 1 millisecond.
+     */
+    Ice::optional<int> batchFlushInterval;
+
+    /**
+     * Specifies the lane used to send the writer samples. The samples of writers with a lane greater than 0 are
+     * sent over a dedicated connection for this lane, shared by the writers of the node with the same lane, rather
+     * than over the session connection. Lanes prevent large or bulk samples from delaying latency-critical samples
+     * queued behind them on the same connection. The samples are sent over the session connection while the lane
+     * connection is being established, or if the reader node has no endpoints to establish it. The default lane
+     * is 0, the session connection.
+     */
+    Ice::optional<int> lane;
 };
 
+/**
+ * The notification handle of a reader, a file descriptor on POSIX platforms and an event handle on Windows. The
+ * handle can be polled by an event loop, it's readable while the reader has unread samples.
+ */
+#ifdef _WIN32
+using NotificationHandle = void*;
+#else
+using NotificationHandle = int;
+#endif
+
 /**
  * The callback action enumerator specifies the reason why a callback is called.
  */
@@ -251,7 +475,8 @@ struct Cloner
     /**
      * Clone the given value. This helper is used when processing partial update to clone the previous value
      * and compute the new value with the partial update. The default implementation performs a plain C++ copy
-     * with the copy constructor.
+     * with the copy constructor. Partial updates without an updater share the previous value and don't clone
+     * it. Large members of the value can be held by Shared objects to avoid copying them.
      *
      * @param value The value to encode
      * @return The cloned value
@@ -262,6 +487,100 @@ struct Cloner
     }
 };
 
+/**
+ * The TrivialEncoding trait enables the trivial encoding of a type. Values of a type with trivial encoding are
+ * encoded with a plain copy of their memory representation instead of the Ice encoding. The trivial encoding is
+ * enabled by default for bool and the signed integral and floating point types supported by Ice; it's compatible
+ * with the Ice encoding of these types.
+ *
+ * The trait can be specialized to enable the trivial encoding for trivially copyable types with a fixed layout,
+ * for example:
+ *
+ * <pre>
+ * template<> struct DataStorm::TrivialEncoding<Tick> : std::true_type {};
+ * </pre>
+ *
+ * Arithmetic types are always encoded in little endian. Other types are encoded in the byte order of the host,
+ * the trivial encoding should only be enabled for such types if all the nodes share the same memory layout.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+template<typename T, typename Enabler=void>
+struct TrivialEncoding : std::false_type
+{
+};
+
+/** @private */
+template<typename T>
+struct TrivialEncoding<T, typename std::enable_if<std::is_same<T, bool>::value ||
+                                                  std::is_same<T, unsigned char>::value ||
+                                                  std::is_same<T, short>::value ||
+                                                  std::is_same<T, int>::value ||
+                                                  std::is_same<T, long long int>::value ||
+                                                  std::is_same<T, float>::value ||
+                                                  std::is_same<T, double>::value>::type> : std::true_type
+{
+};
+
+/**
+ * Encoder template specialization to encode types with trivial encoding.
+ **/
+template<typename T>
+struct Encoder<T, typename std::enable_if<TrivialEncoding<T>::value>::type>
+{
+#if defined(__clang__) || !defined(__GNUC__) || ((__GNUC__* 100) + __GNUC_MINOR__) >= 500
+    static_assert(std::is_trivially_copyable<T>::value, "trivial encoding requires a trivially copyable type");
+#endif
+
+    static std::vector<unsigned char>
+    encode(const std::shared_ptr<Ice::Communicator>&, const T& value) noexcept
+    {
+        auto p = reinterpret_cast<const unsigned char*>(&value);
+        std::vector<unsigned char> data(p, p + sizeof(T));
+#ifdef ICE_BIG_ENDIAN
+        if(std::is_arithmetic<T>::value)
+        {
+            std::reverse(data.begin(), data.end());
+        }
+#endif
+        return data;
+    }
+};
+
+/**
+ * Decoder template specialization to decode types with trivial encoding.
+ **/
+template<typename T>
+struct Decoder<T, typename std::enable_if<TrivialEncoding<T>::value>::type>
+{
+    static T
+    decode(const std::shared_ptr<Ice::Communicator>&, const std::vector<unsigned char>& data) noexcept
+    {
+        T value;
+        if(data.empty())
+        {
+            value = T();
+        }
+        else if(data.size() != sizeof(T))
+        {
+            // Like a failure to decode a value with the Ice encoding.
+            std::terminate();
+        }
+        else
+        {
+#ifdef ICE_BIG_ENDIAN
+            if(std::is_arithmetic<T>::value)
+            {
+                std::reverse_copy(data.begin(), data.end(), reinterpret_cast<unsigned char*>(&value));
+                return value;
+            }
+#endif
+            std::memcpy(&value, data.data(), sizeof(T));
+        }
+        return value;
+    }
+};
+
 /**
  * Encoder template specialization to encode Ice::Value instances.
  **/
@@ -301,6 +620,125 @@ struct Cloner<std::shared_ptr<T>, typename std::enable_if<std::is_base_of<::Ice:
     }
 };
 
+/**
+ * The Shared template holds a copy-on-write value. Copying a Shared object doesn't copy the value, the copies share
+ * the same value until one of them is modified with write(). Value types with large members held by Shared objects
+ * are cheap to clone: the clone of the previous value computed by a partial update only copies the members that the
+ * updater modifies, for example:
+ *
+ * <pre>
+ * struct Frame
+ * {
+ *     DataStorm::Shared<std::vector<unsigned char>> pixels;
+ *     DataStorm::Shared<std::string> title;
+ * };
+ *
+ * topic.setUpdater<std::string>("title", [](Frame& frame, std::string title) { frame.title.write() = title; });
+ * </pre>
+ *
+ * A Shared object is encoded and decoded like the value it holds.
+ *
+ * @headerfile DataStorm/DataStorm.h
+ */
+template<typename T>
+class Shared
+{
+public:
+
+    /**
+     * Construct a Shared object holding a default value.
+     */
+    Shared() noexcept = default;
+
+    /**
+     * Construct a Shared object holding the given value.
+     *
+     * @param value The value
+     */
+    Shared(T value) : _value(std::make_shared<T>(std::move(value)))
+    {
+    }
+
+    /**
+     * Get the value.
+     *
+     * @return The value
+     */
+    const T& get() const noexcept
+    {
+        static const T defaultValue = T();
+        return _value ? *_value : defaultValue;
+    }
+
+    /**
+     * Get the value for modification. The value is copied first if it's shared with other Shared objects.
+     *
+     * @return The value
+     */
+    T& write()
+    {
+        if(!_value)
+        {
+            _value = std::make_shared<T>();
+        }
+        else if(_value.use_count() > 1)
+        {
+            _value = std::make_shared<T>(*_value);
+        }
+        return *_value;
+    }
+
+    /**
+     * Get the value.
+     *
+     * @return The value
+     */
+    const T& operator*() const noexcept
+    {
+        return get();
+    }
+
+    /**
+     * Get a pointer to the value.
+     *
+     * @return The pointer to the value
+     */
+    const T* operator->() const noexcept
+    {
+        return &get();
+    }
+
+private:
+
+    std::shared_ptr<T> _value;
+};
+
+/**
+ * Encoder template specialization to encode Shared objects.
+ **/
+template<typename T>
+struct Encoder<Shared<T>>
+{
+    static std::vector<unsigned char>
+    encode(const std::shared_ptr<Ice::Communicator>& communicator, const Shared<T>& value) noexcept
+    {
+        return Encoder<T>::encode(communicator, value.get());
+    }
+};
+
+/**
+ * Decoder template specialization to decode Shared objects.
+ **/
+template<typename T>
+struct Decoder<Shared<T>>
+{
+    static Shared<T>
+    decode(const std::shared_ptr<Ice::Communicator>& communicator, const std::vector<unsigned char>& data) noexcept
+    {
+        return Shared<T>(Decoder<T>::decode(communicator, data));
+    }
+};
+
 /**
  * Encoder template implementation
  */
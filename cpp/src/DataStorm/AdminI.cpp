@@ -0,0 +1,46 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/AdminI.h>
+#include <DataStorm/TopicFactoryI.h>
+#include <DataStorm/NodeI.h>
+#include <DataStorm/CallbackExecutor.h>
+#include <DataStorm/Timer.h>
+#include <DataStorm/FlightRecorder.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace DataStormI;
+
+NodeAdminI::NodeAdminI(shared_ptr<TopicFactoryI> factory,
+                       shared_ptr<NodeI> node,
+                       shared_ptr<CallbackExecutor> executor,
+                       shared_ptr<Timer> timer) :
+    _factory(move(factory)),
+    _node(move(node)),
+    _executor(move(executor)),
+    _timer(move(timer))
+{
+}
+
+DataStorm::NodeDescription
+NodeAdminI::describe(const Ice::Current&)
+{
+    DataStorm::NodeDescription description;
+    description.node = _node->getProxy()->ice_toString();
+    description.topics = _factory->describe();
+    description.sessions = _node->getSessionDescriptions();
+    description.callbackQueueDepth = static_cast<long long int>(_executor->getQueueSize());
+    description.timerQueueSize = static_cast<long long int>(_timer->getSize());
+    return description;
+}
+
+DataStorm::ByteSeq
+NodeAdminI::getFlightRecording(const Ice::Current&)
+{
+    ostringstream os;
+    FlightRecorder::dump(os);
+    auto recording = os.str();
+    return DataStorm::ByteSeq(recording.begin(), recording.end());
+}
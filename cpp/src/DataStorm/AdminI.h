@@ -0,0 +1,36 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/Admin.h>
+
+namespace DataStormI
+{
+
+class TopicFactoryI;
+class NodeI;
+class CallbackExecutor;
+class Timer;
+
+class NodeAdminI : public DataStorm::NodeAdmin
+{
+public:
+
+    NodeAdminI(std::shared_ptr<TopicFactoryI>,
+               std::shared_ptr<NodeI>,
+               std::shared_ptr<CallbackExecutor>,
+               std::shared_ptr<Timer>);
+
+    virtual DataStorm::NodeDescription describe(const Ice::Current&) override;
+    virtual DataStorm::ByteSeq getFlightRecording(const Ice::Current&) override;
+
+private:
+
+    const std::shared_ptr<TopicFactoryI> _factory;
+    const std::shared_ptr<NodeI> _node;
+    const std::shared_ptr<CallbackExecutor> _executor;
+    const std::shared_ptr<Timer> _timer;
+};
+
+}
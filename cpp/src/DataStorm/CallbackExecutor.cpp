@@ -6,7 +6,7 @@
 using namespace std;
 using namespace DataStormI;
 
-CallbackExecutor::CallbackExecutor() : _flush(false), _destroyed(false)
+CallbackExecutor::CallbackExecutor() : _flush(false), _destroyed(false), _running(0)
 {
     _thread = thread([this]
     {
@@ -23,6 +23,7 @@ CallbackExecutor::CallbackExecutor() : _flush(false), _destroyed(false)
             {
                 _flush = false;
                 _queue.swap(queue);
+                _running = queue.size();
             }
 
             lock.unlock();
@@ -38,6 +39,9 @@ CallbackExecutor::CallbackExecutor() : _flush(false), _destroyed(false)
                 }
             }
             queue.clear();
+
+            lock.lock();
+            _running = 0;
         }
     });
 }
@@ -54,6 +58,13 @@ CallbackExecutor::queue(const std::shared_ptr<DataElementI>& element, std::funct
     }
 }
 
+size_t
+CallbackExecutor::getQueueSize() const
+{
+    unique_lock<mutex> lock(_mutex);
+    return _queue.size() + _running;
+}
+
 void
 CallbackExecutor::flush()
 {
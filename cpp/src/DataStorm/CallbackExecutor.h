@@ -22,16 +22,18 @@ public:
     CallbackExecutor();
 
     void queue(const std::shared_ptr<DataElementI>&, std::function<void()>, bool = false);
+    size_t getQueueSize() const;
     void flush();
     void destroy();
 
 private:
 
-    std::mutex _mutex;
+    mutable std::mutex _mutex;
     std::thread _thread;
     std::condition_variable _cond;
     bool _flush;
     bool _destroyed;
+    size_t _running;
     std::vector<std::pair<std::shared_ptr<DataElementI>, std::function<void()>>> _queue;
 };
 
@@ -4,9 +4,12 @@
 #include <DataStorm/DataElementI.h>
 #include <DataStorm/TopicI.h>
 #include <DataStorm/NodeI.h>
+#include <DataStorm/NodeSessionI.h>
+#include <DataStorm/SessionI.h>
 #include <DataStorm/Instance.h>
 #include <DataStorm/TraceUtil.h>
 #include <DataStorm/CallbackExecutor.h>
+#include <DataStorm/FlightRecorder.h>
 
 using namespace std;
 using namespace DataStormI;
@@ -27,7 +30,74 @@ toSample(const shared_ptr<Sample>& sample, const shared_ptr<Ice::Communicator>&
              sample->encode(communicator) };
 }
 
-void
+string
+toString(ClearHistoryPolicy policy)
+{
+    switch(policy)
+    {
+    case ClearHistoryPolicy::OnAdd:
+        return "OnAdd";
+    case ClearHistoryPolicy::OnRemove:
+        return "OnRemove";
+    case ClearHistoryPolicy::OnAll:
+        return "OnAll";
+    case ClearHistoryPolicy::OnAllExceptPartialUpdate:
+        return "OnAllExceptPartialUpdate";
+    case ClearHistoryPolicy::Never:
+        return "Never";
+    }
+    return "";
+}
+
+string
+toString(DataStorm::DiscardPolicy policy)
+{
+    switch(policy)
+    {
+    case DataStorm::DiscardPolicy::None:
+        return "None";
+    case DataStorm::DiscardPolicy::SendTime:
+        return "SendTime";
+    case DataStorm::DiscardPolicy::Priority:
+        return "Priority";
+    case DataStorm::DiscardPolicy::KeepLatestPerKey:
+        return "KeepLatestPerKey";
+    }
+    return "";
+}
+
+string
+toString(DataStorm::SlowConsumerPolicy policy)
+{
+    switch(policy)
+    {
+    case DataStorm::SlowConsumerPolicy::Drop:
+        return "Drop";
+    case DataStorm::SlowConsumerPolicy::Conflate:
+        return "Conflate";
+    case DataStorm::SlowConsumerPolicy::Disconnect:
+        return "Disconnect";
+    }
+    return "";
+}
+
+string
+toString(DataStorm::FlowControlPolicy policy)
+{
+    switch(policy)
+    {
+    case DataStorm::FlowControlPolicy::Drop:
+        return "Drop";
+    case DataStorm::FlowControlPolicy::Block:
+        return "Block";
+    }
+    return "";
+}
+
+// The delay before retrying to send the conflated samples of a slow consumer
+const chrono::milliseconds slowConsumerRetryDelay(10);
+
+bool
 cleanOldSamples(deque<shared_ptr<Sample>>& samples,
                 const chrono::time_point<chrono::system_clock>& now,
                 int lifetime)
@@ -38,7 +108,9 @@ cleanOldSamples(deque<shared_ptr<Sample>>& samples,
     if(p != samples.begin())
     {
         samples.erase(samples.begin(), p);
+        return true;
     }
+    return false;
 }
 
 }
@@ -50,10 +122,10 @@ DataElementI::DataElementI(TopicI* parent, const string& name, long long int id,
     _config(make_shared<ElementConfig>()),
     _executor(parent->getInstance()->getCallbackExecutor()),
     _listenerCount(0),
+    _destroyed(false),
     _parent(parent->shared_from_this()),
     _waiters(0),
-    _notified(0),
-    _destroyed(false)
+    _notified(0)
 {
     _config->sampleCount = config.sampleCount;
     _config->sampleLifetime = config.sampleLifetime;
@@ -70,8 +142,8 @@ DataElementI::DataElementI(TopicI* parent, const string& name, long long int id,
 void
 DataElementI::init()
 {
-    auto forwarder = [self=shared_from_this()](Ice::ByteSeq e, const Ice::Current& c) { self->forward(e, c); };
-    _forwarder = Ice::uncheckedCast<SessionPrx>(_parent->getInstance()->getCollocatedForwarder()->add(move(forwarder)));
+    auto forwarder = _parent->getInstance()->getCollocatedForwarder()->add(shared_from_this());
+    _forwarder = Ice::uncheckedCast<SessionPrx>(forwarder);
 }
 
 DataElementI::~DataElementI()
@@ -89,6 +161,10 @@ DataElementI::destroy()
         assert(!_destroyed);
         _destroyed = true;
         destroyImpl(); // Must be called first.
+
+        // The asynchronous waits won't complete, the waiters are completed with an exception.
+        completeWaiters(make_exception_ptr(logic_error("data element destroyed")));
+        _executor->flush();
     }
     disconnect();
     _parent->getInstance()->getCollocatedForwarder()->remove(_forwarder->ice_getIdentity());
@@ -124,8 +200,10 @@ DataElementI::attach(long long int topicId,
         os << session->getId() << '-' << topicId << '-' << data.id;
         name = os.str();
     }
-    if((id > 0 && attachKey(topicId, data.id, key, sampleFilter, session, prx, facet, id, name, priority)) ||
-       (id < 0 && attachFilter(topicId, data.id, key, sampleFilter, session, prx, facet, id, filter, name, priority)))
+    if((id > 0 && attachKey(topicId, data.id, key, sampleFilter, session, prx, facet, id, name, priority,
+                            data.config)) ||
+       (id < 0 && attachFilter(topicId, data.id, key, sampleFilter, session, prx, facet, id, filter, name, priority,
+                               data.config)))
     {
         auto q = data.lastIds.find(_id);
         long long lastId = q != data.lastIds.end() ? q->second : 0;
@@ -165,19 +243,32 @@ DataElementI::attach(long long int topicId,
         os << session->getId() << '-' << topicId << '-' << data.id;
         name = os.str();
     }
-    if((id > 0 && attachKey(topicId, data.id, key, sampleFilter, session, prx, facet, id, name, priority)) ||
-       (id < 0 && attachFilter(topicId, data.id, key, sampleFilter, session, prx, facet, id, filter, name, priority)))
+    if((id > 0 && attachKey(topicId, data.id, key, sampleFilter, session, prx, facet, id, name, priority,
+                            data.config)) ||
+       (id < 0 && attachFilter(topicId, data.id, key, sampleFilter, session, prx, facet, id, filter, name, priority,
+                               data.config)))
     {
         auto q = data.lastIds.find(_id);
         long long lastId = q != data.lastIds.end() ? q->second : 0;
         samples.push_back(getSamples(key, sampleFilter, data.config, lastId, now));
     }
 
+    vector<SessionI::PendingSample> pending;
     auto samplesI = session->subscriberInitialized(topicId, id > 0 ? data.id : -data.id, data.samples, key,
-                                                   shared_from_this());
-    if(!samplesI.empty())
+                                                   shared_from_this(), pending);
+    if(!samplesI.empty() || !pending.empty())
     {
-        return [=]() { initSamples(samplesI, topicId, data.id, priority, now, id < 0); };
+        return [=]()
+        {
+            if(!samplesI.empty())
+            {
+                initSamples(samplesI, topicId, data.id, priority, now, id < 0);
+            }
+            for(const auto& p : pending)
+            {
+                queue(p.sample, priority, session, p.facet, now, p.checkKey);
+            }
+        };
     }
     return nullptr;
 }
@@ -192,7 +283,8 @@ DataElementI::attachKey(long long int topicId,
                         const string& facet,
                         long long int keyId,
                         const string& name,
-                        int priority)
+                        int priority,
+                        const shared_ptr<ElementConfig>& config)
 {
     // No locking necessary, called by the session with the mutex locked
     auto p = _listeners.find({ session, facet });
@@ -203,6 +295,10 @@ DataElementI::attachKey(long long int topicId,
 
     bool added = false;
     auto subscriber = p->second.addOrGet(topicId, elementId, keyId, nullptr, sampleFilter, name, priority, added);
+    if(added)
+    {
+        p->second.addConfig(subscriber, config);
+    }
     if(_onConnectedElements && added)
     {
         _executor->queue(shared_from_this(), [=]
@@ -254,9 +350,14 @@ DataElementI::detachKey(long long int topicId,
     auto subscriber = p->second.get(topicId, elementId);
     if(removeConnectedKey(key, subscriber))
     {
+        if(p->second.flowControl)
+        {
+            _parent->_cond.notify_all(); // Wake up the publishers waiting for the reader credit
+        }
         if(key)
         {
             subscriber->keys.erase(key);
+            p->second.removeConflation(key, *_parent->getInstance()->getTimer());
         }
         if(subscriber->keys.empty())
         {
@@ -304,7 +405,8 @@ DataElementI::attachFilter(long long int topicId,
                            long long int filterId,
                            const shared_ptr<Filter>& filter,
                            const string& name,
-                           int priority)
+                           int priority,
+                           const shared_ptr<ElementConfig>& config)
 {
     // No locking necessary, called by the session with the mutex locked
     auto p = _listeners.find({ session, facet });
@@ -315,6 +417,10 @@ DataElementI::attachFilter(long long int topicId,
 
     bool added = false;
     auto subscriber = p->second.addOrGet(topicId, -elementId, filterId, filter, sampleFilter, name, priority, added);
+    if(added)
+    {
+        p->second.addConfig(subscriber, config);
+    }
     if(_onConnectedElements && added)
     {
         _executor->queue(shared_from_this(), [=]
@@ -366,9 +472,14 @@ DataElementI::detachFilter(long long int topicId,
     auto subscriber = p->second.get(topicId, -elementId);
     if(removeConnectedKey(key, subscriber))
     {
+        if(p->second.flowControl)
+        {
+            _parent->_cond.notify_all(); // Wake up the publishers waiting for the reader credit
+        }
         if(key)
         {
             subscriber->keys.erase(key);
+            p->second.removeConflation(key, *_parent->getInstance()->getTimer());
         }
         if(subscriber->keys.empty())
         {
@@ -498,6 +609,11 @@ DataElementI::queue(const shared_ptr<Sample>&, int, const shared_ptr<SessionI>&,
     assert(false);
 }
 
+void
+DataElementI::credit(const shared_ptr<SessionI>&, const string&, long long int, int)
+{
+}
+
 shared_ptr<DataStormContract::ElementConfig>
 DataElementI::getConfig() const
 {
@@ -512,12 +628,7 @@ DataElementI::waitForListeners(int count) const
     while(true)
     {
         _parent->getInstance()->checkShutdown();
-        if(count < 0 && _listenerCount == 0)
-        {
-            --_waiters;
-            return;
-        }
-        else if(count >= 0 && _listenerCount >= static_cast<size_t>(count))
+        if(matchListenerCount(count))
         {
             --_waiters;
             return;
@@ -527,6 +638,25 @@ DataElementI::waitForListeners(int count) const
     }
 }
 
+void
+DataElementI::waitForListenersAsync(int count, function<void(exception_ptr)> callback)
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    if(_parent->getInstance()->isShutdown())
+    {
+        auto ex = make_exception_ptr(DataStorm::NodeShutdownException());
+        _executor->queue(shared_from_this(), [callback, ex] { callback(ex); }, true);
+    }
+    else if(matchListenerCount(count))
+    {
+        _executor->queue(shared_from_this(), [callback] { callback(nullptr); }, true);
+    }
+    else
+    {
+        _asyncWaiters.emplace_back(count, move(callback));
+    }
+}
+
 bool
 DataElementI::hasListeners() const
 {
@@ -540,6 +670,99 @@ DataElementI::getCommunicator() const
     return _parent->getInstance()->getCommunicator();
 }
 
+DataStorm::ElementMetrics
+DataElementI::getMetrics() const
+{
+    // Called with the topic mutex locked
+    DataStorm::ElementMetrics metrics;
+    metrics.id = _id;
+    metrics.name = _name;
+    metrics.reader = false;
+    metrics.published = _counters.published;
+    metrics.queued = _counters.queued;
+    metrics.discardedSendTime = _counters.discardedSendTime;
+    metrics.discardedPriority = _counters.discardedPriority;
+    metrics.discardedFlowControl = _counters.discardedFlowControl;
+    metrics.discardedSlowConsumer = _counters.discardedSlowConsumer;
+    metrics.slowConsumers = _counters.slowConsumers;
+    metrics.filtered = _counters.filtered;
+    metrics.historyDepth = 0;
+    metrics.listenerCount = static_cast<int>(_listenerCount);
+    return metrics;
+}
+
+DataStorm::ElementDescription
+DataElementI::describe() const
+{
+    // Called with the topic mutex locked
+    DataStorm::ElementDescription description;
+    description.id = _id;
+    description.description = toString();
+    description.reader = false;
+    if(_config->facet)
+    {
+        description.config["facet"] = *_config->facet;
+    }
+    if(_config->sampleFilter)
+    {
+        description.config["sampleFilter"] = _config->sampleFilter->name;
+    }
+    if(_config->name)
+    {
+        description.config["name"] = *_config->name;
+    }
+    if(_config->priority)
+    {
+        description.config["priority"] = to_string(*_config->priority);
+    }
+    if(_config->maxUpdateRate)
+    {
+        description.config["maxUpdateRate"] = to_string(*_config->maxUpdateRate);
+    }
+    if(_config->maxUnreadSamples)
+    {
+        description.config["maxUnreadSamples"] = to_string(*_config->maxUnreadSamples);
+    }
+    if(_config->maxUnreadBytes)
+    {
+        description.config["maxUnreadBytes"] = to_string(*_config->maxUnreadBytes);
+    }
+    if(_config->sampleCount)
+    {
+        description.config["sampleCount"] = to_string(*_config->sampleCount);
+    }
+    if(_config->sampleLifetime)
+    {
+        description.config["sampleLifetime"] = to_string(*_config->sampleLifetime);
+    }
+    if(_config->compositeUpdates)
+    {
+        description.config["compositeUpdates"] = *_config->compositeUpdates ? "true" : "false";
+    }
+    if(_config->clearHistory)
+    {
+        description.config["clearHistory"] = ::toString(*_config->clearHistory);
+    }
+    description.historyDepth = 0;
+    description.listenerCount = static_cast<int>(_listenerCount);
+    for(const auto& listener : _listeners)
+    {
+        for(const auto& subscriber : listener.second.subscribers)
+        {
+            description.connectedElements.push_back(subscriber.second->name);
+        }
+    }
+    return description;
+}
+
+void
+DataElementI::incCounter(long long int SampleCounters::* counter, long long int value) const
+{
+    // Called with the topic mutex locked, the topic counters include the counters of all its elements
+    _counters.*counter += value;
+    _parent->_counters.*counter += value;
+}
+
 bool
 DataElementI::addConnectedKey(const shared_ptr<Key>& key, const shared_ptr<Subscriber>& subscriber)
 {
@@ -586,6 +809,25 @@ DataElementI::removeConnectedKey(const shared_ptr<Key>& key, const shared_ptr<Su
 void
 DataElementI::notifyListenerWaiters(unique_lock<mutex>& lock) const
 {
+    if(!_asyncWaiters.empty())
+    {
+        auto self = const_pointer_cast<DataElementI>(shared_from_this());
+        auto p = _asyncWaiters.begin();
+        while(p != _asyncWaiters.end())
+        {
+            if(matchListenerCount(p->first))
+            {
+                auto callback = move(p->second);
+                _executor->queue(self, [callback] { callback(nullptr); }, true);
+                p = _asyncWaiters.erase(p);
+            }
+            else
+            {
+                ++p;
+            }
+        }
+    }
+
     if(_waiters > 0)
     {
         _notified = 0;
@@ -594,6 +836,33 @@ DataElementI::notifyListenerWaiters(unique_lock<mutex>& lock) const
     }
 }
 
+bool
+DataElementI::matchListenerCount(int count) const
+{
+    // Called with the topic mutex locked
+    return count < 0 ? _listenerCount == 0 : _listenerCount >= static_cast<size_t>(count);
+}
+
+void
+DataElementI::shutdown()
+{
+    // Called with the topic mutex locked
+    completeWaiters(make_exception_ptr(DataStorm::NodeShutdownException()));
+    _executor->flush();
+}
+
+void
+DataElementI::completeWaiters(exception_ptr ex)
+{
+    // Called with the topic mutex locked
+    for(const auto& waiter : _asyncWaiters)
+    {
+        auto callback = waiter.second;
+        _executor->queue(shared_from_this(), [callback, ex] { callback(ex); });
+    }
+    _asyncWaiters.clear();
+}
+
 void
 DataElementI::disconnect()
 {
@@ -627,11 +896,7 @@ DataElementI::forward(const Ice::ByteSeq& inEncaps, const Ice::Current& current)
 {
     for(const auto& listener : _listeners)
     {
-        // If there's at least one subscriber interested in the update
-        if(!_sample || listener.second.matchOne(_sample, false))
-        {
-            listener.second.proxy->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
-        }
+        listener.second.proxy->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
     }
 }
 
@@ -643,12 +908,36 @@ DataReaderI::DataReaderI(TopicReaderI* topic,
                          const DataStorm::ReaderConfig& config) :
     DataElementI(topic, name, id, config),
     _parent(topic),
-    _discardPolicy(config.discardPolicy ? *config.discardPolicy : DataStorm::DiscardPolicy::None)
+    _pushedCount(0),
+    _discardPolicy(config.discardPolicy ? *config.discardPolicy : DataStorm::DiscardPolicy::None),
+    _notifierSignaled(false),
+    _latencyStatistics(config.latencyStatistics && *config.latencyStatistics),
+    _averageSampleSize(0),
+    _receivedSinceCredit(0)
 {
     if(!sampleFilterName.empty())
     {
         _config->sampleFilter = FilterInfo { sampleFilterName, move(sampleFilterCriteria) };
     }
+    if(config.maxUpdateRate && *config.maxUpdateRate > 0)
+    {
+        _config->maxUpdateRate = config.maxUpdateRate;
+    }
+    if(config.maxUnreadSamples && *config.maxUnreadSamples > 0)
+    {
+        _config->maxUnreadSamples = config.maxUnreadSamples;
+    }
+    if(config.maxUnreadBytes && *config.maxUnreadBytes > 0)
+    {
+        _config->maxUnreadBytes = config.maxUnreadBytes;
+    }
+    if(_parent->getInstance()->getCompositeUpdates())
+    {
+        _config->compositeUpdates = true;
+    }
+
+    // The writers initially assume the credit of the reader is its maximum number of unread samples
+    _credit = static_cast<size_t>(_config->maxUnreadSamples ? *_config->maxUnreadSamples : numeric_limits<int>::max());
 }
 
 int
@@ -664,9 +953,35 @@ DataReaderI::getAllUnread()
     lock_guard<mutex> lock(_parent->_mutex);
     vector<shared_ptr<Sample>> unread(_samples.begin(), _samples.end());
     _samples.clear();
+    updateNotifier();
+    grantCredit();
+    return unread;
+}
+
+vector<shared_ptr<Sample>>
+DataReaderI::getUnread(unsigned int count)
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    auto end = _samples.begin() + static_cast<ptrdiff_t>(min(static_cast<size_t>(count), _samples.size()));
+    vector<shared_ptr<Sample>> unread(_samples.begin(), end);
+    _samples.erase(_samples.begin(), end);
+    updateNotifier();
+    grantCredit();
     return unread;
 }
 
+DataStorm::NotificationHandle
+DataReaderI::getNotificationHandle()
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    if(!_notifier)
+    {
+        _notifier.reset(new Notifier());
+        updateNotifier();
+    }
+    return _notifier->getHandle();
+}
+
 void
 DataReaderI::waitForUnread(unsigned int count) const
 {
@@ -674,6 +989,39 @@ DataReaderI::waitForUnread(unsigned int count) const
     _parent->_cond.wait(lock, [&]() { _parent->getInstance()->checkShutdown(); return _samples.size() >= count; });
 }
 
+DataStorm::ElementMetrics
+DataReaderI::getMetrics() const
+{
+    auto metrics = DataElementI::getMetrics();
+    metrics.reader = true;
+    metrics.historyDepth = static_cast<long long int>(_samples.size());
+    return metrics;
+}
+
+DataStorm::ElementDescription
+DataReaderI::describe() const
+{
+    auto description = DataElementI::describe();
+    description.reader = true;
+    description.config["discardPolicy"] = ::toString(_discardPolicy);
+    description.historyDepth = static_cast<long long int>(_samples.size());
+    return description;
+}
+
+DataStorm::LatencyStatistics
+DataReaderI::getLatencyStatistics() const
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    return _latency.getStatistics();
+}
+
+void
+DataReaderI::resetLatencyStatistics()
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    _latency.reset();
+}
+
 bool
 DataReaderI::hasUnread() const
 {
@@ -688,9 +1036,127 @@ DataReaderI::getNextUnread()
     _parent->_cond.wait(lock, [&]() { _parent->getInstance()->checkShutdown(); return !_samples.empty(); });
     shared_ptr<Sample> sample = _samples.front();
     _samples.pop_front();
+    updateNotifier();
+    grantCredit();
     return sample;
 }
 
+void
+DataReaderI::waitForUnreadAsync(unsigned int count, function<void(exception_ptr)> callback)
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    if(_parent->getInstance()->isShutdown())
+    {
+        auto ex = make_exception_ptr(DataStorm::NodeShutdownException());
+        _executor->queue(shared_from_this(), [callback, ex] { callback(ex); }, true);
+    }
+    else if(_samples.size() >= count)
+    {
+        _executor->queue(shared_from_this(), [callback] { callback(nullptr); }, true);
+    }
+    else
+    {
+        _unreadWaiters.emplace_back(count, move(callback));
+    }
+}
+
+void
+DataReaderI::getNextUnreadAsync(function<void(shared_ptr<Sample>, exception_ptr)> callback)
+{
+    lock_guard<mutex> lock(_parent->_mutex);
+    if(_parent->getInstance()->isShutdown())
+    {
+        auto ex = make_exception_ptr(DataStorm::NodeShutdownException());
+        _executor->queue(shared_from_this(), [callback, ex] { callback(nullptr, ex); }, true);
+    }
+    else
+    {
+        _nextUnreadWaiters.push_back(move(callback));
+        notifyUnreadWaiters();
+    }
+}
+
+void
+DataReaderI::completeWaiters(exception_ptr ex)
+{
+    // Called with the topic mutex locked
+    for(const auto& waiter : _unreadWaiters)
+    {
+        auto callback = waiter.second;
+        _executor->queue(shared_from_this(), [callback, ex] { callback(ex); });
+    }
+    _unreadWaiters.clear();
+    for(const auto& callback : _nextUnreadWaiters)
+    {
+        _executor->queue(shared_from_this(), [callback, ex] { callback(nullptr, ex); });
+    }
+    _nextUnreadWaiters.clear();
+    DataElementI::completeWaiters(ex);
+}
+
+void
+DataReaderI::notifyUnreadWaiters()
+{
+    // Called with the topic mutex locked
+    if(_unreadWaiters.empty() && _nextUnreadWaiters.empty())
+    {
+        updateNotifier();
+        grantCredit();
+        return;
+    }
+
+    auto self = shared_from_this();
+    auto p = _unreadWaiters.begin();
+    while(p != _unreadWaiters.end())
+    {
+        if(_samples.size() >= p->first)
+        {
+            auto callback = move(p->second);
+            _executor->queue(self, [callback] { callback(nullptr); });
+            p = _unreadWaiters.erase(p);
+        }
+        else
+        {
+            ++p;
+        }
+    }
+
+    // The unread samples are handed out to the waiters in the order they started waiting.
+    while(!_nextUnreadWaiters.empty() && !_samples.empty())
+    {
+        auto callback = move(_nextUnreadWaiters.front());
+        auto sample = _samples.front();
+        _nextUnreadWaiters.pop_front();
+        _samples.pop_front();
+        _executor->queue(self, [callback, sample] { callback(sample, nullptr); });
+    }
+    _executor->flush();
+    updateNotifier();
+    grantCredit();
+}
+
+void
+DataReaderI::updateNotifier()
+{
+    // Called with the topic mutex locked
+    //
+    // The notifier is signaled while the reader has unread samples, it's only signaled or reset when the
+    // unread samples become available or are all consumed to save system calls.
+    //
+    if(_notifier && _notifierSignaled == _samples.empty())
+    {
+        _notifierSignaled = !_samples.empty();
+        if(_notifierSignaled)
+        {
+            _notifier->signal();
+        }
+        else
+        {
+            _notifier->reset();
+        }
+    }
+}
+
 void
 DataReaderI::initSamples(const vector<shared_ptr<Sample>>& samples,
                          long long int topic,
@@ -711,20 +1177,27 @@ DataReaderI::initSamples(const vector<shared_ptr<Sample>>& samples,
     {
         if(checkKey && !matchKey(sample->key))
         {
+            incCounter(&SampleCounters::filtered);
+            FlightRecorder::record(FlightEvent::Filtered, _parent->getId(), _id, sample->id);
             continue;
         }
         else if(_discardPolicy == DataStorm::DiscardPolicy::SendTime &&
                 sample->timestamp <= _lastSendTime)
         {
+            incCounter(&SampleCounters::discardedSendTime);
+            FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, sample->id);
             continue;
         }
         else if(_discardPolicy == DataStorm::DiscardPolicy::Priority &&
                 priority < _connectedKeys[sample->key].back()->priority)
         {
+            incCounter(&SampleCounters::discardedPriority);
+            FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, sample->id);
             continue;
         }
         assert(sample->key);
         valid.push_back(sample);
+        FlightRecorder::record(FlightEvent::Initialized, _parent->getId(), _id, sample->id);
 
         if(!sample->hasValue())
         {
@@ -761,11 +1234,15 @@ DataReaderI::initSamples(const vector<shared_ptr<Sample>>& samples,
     {
         return;
     }
+    incCounter(&SampleCounters::queued, static_cast<long long int>(valid.size()));
     _lastSendTime = valid.back()->timestamp;
 
     if(_config->sampleLifetime && *_config->sampleLifetime > 0)
     {
-        cleanOldSamples(_samples, now, *_config->sampleLifetime);
+        if(cleanOldSamples(_samples, now, *_config->sampleLifetime))
+        {
+            rebuildKeySlots(); // The stale samples aren't necessarily at the front of the queue
+        }
     }
 
     if(_config->sampleCount)
@@ -793,7 +1270,7 @@ DataReaderI::initSamples(const vector<shared_ptr<Sample>>& samples,
     if(_config->clearHistory && *_config->clearHistory == ClearHistoryPolicy::OnAll)
     {
         _samples.clear();
-        _samples.push_back(valid.back());
+        pushUnread(valid.back());
     }
     else
     {
@@ -807,12 +1284,18 @@ DataReaderI::initSamples(const vector<shared_ptr<Sample>>& samples,
             {
                 _samples.clear();
             }
-            _samples.push_back(s);
+            else if(replaceUnread(s))
+            {
+                continue;
+            }
+            pushUnread(s);
         }
     }
+    trimUnread();
     assert(!_samples.empty());
     _last = _samples.back();
     _parent->_cond.notify_all();
+    notifyUnreadWaiters();
 }
 
 void
@@ -830,6 +1313,8 @@ DataReaderI::queue(const shared_ptr<Sample>& sample,
             Trace out(_traceLevels, _traceLevels->dataCat);
             out << this << ": skipped sample " << sample->id << " (facet doesn't match)";
         }
+        incCounter(&SampleCounters::filtered);
+        FlightRecorder::record(FlightEvent::Filtered, _parent->getId(), _id, sample->id);
         return;
     }
     else if(checkKey && !matchKey(sample->key))
@@ -839,9 +1324,28 @@ DataReaderI::queue(const shared_ptr<Sample>& sample,
             Trace out(_traceLevels, _traceLevels->dataCat);
             out << this << ": skipped sample " << sample->id << " (key doesn't match)";
         }
+        incCounter(&SampleCounters::filtered);
+        FlightRecorder::record(FlightEvent::Filtered, _parent->getId(), _id, sample->id);
         return;
     }
 
+    if(_config->maxUnreadSamples || _config->maxUnreadBytes)
+    {
+        // The last sample received from the writer session is acknowledged with the next credit
+        auto p = _listeners.find({ session, string() });
+        if(p != _listeners.end())
+        {
+            p->second.lastId = max(p->second.lastId, sample->id);
+        }
+        ++_receivedSinceCredit;
+
+        auto size = sample->getEncodedValue().size();
+        if(size > 0)
+        {
+            _averageSampleSize = _averageSampleSize > 0 ? (_averageSampleSize * 7 + size) / 8 : size;
+        }
+    }
+
     if(_traceLevels->data > 2)
     {
         Trace out(_traceLevels, _traceLevels->dataCat);
@@ -856,6 +1360,15 @@ DataReaderI::queue(const shared_ptr<Sample>& sample,
             Trace out(_traceLevels, _traceLevels->dataCat);
             out << this << ": discarded sample" << sample->id;
         }
+        FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, sample->id);
+        if(_discardPolicy == DataStorm::DiscardPolicy::SendTime)
+        {
+            incCounter(&SampleCounters::discardedSendTime);
+        }
+        else
+        {
+            incCounter(&SampleCounters::discardedPriority);
+        }
         return;
     }
 
@@ -871,6 +1384,15 @@ DataReaderI::queue(const shared_ptr<Sample>& sample,
         }
     }
     _lastSendTime = sample->timestamp;
+    incCounter(&SampleCounters::queued);
+    FlightRecorder::record(FlightEvent::Queued, _parent->getId(), _id, sample->id);
+
+    if(_latencyStatistics)
+    {
+        auto latency = chrono::duration_cast<chrono::microseconds>(now - sample->timestamp);
+        _latency.record(latency);
+        _parent->recordLatency(latency);
+    }
 
     if(_onSamples)
     {
@@ -879,42 +1401,198 @@ DataReaderI::queue(const shared_ptr<Sample>& sample,
 
     if(_config->sampleLifetime && *_config->sampleLifetime > 0)
     {
-        cleanOldSamples(_samples, now, *_config->sampleLifetime);
+        if(cleanOldSamples(_samples, now, *_config->sampleLifetime))
+        {
+            rebuildKeySlots(); // The stale samples aren't necessarily at the front of the queue
+        }
     }
 
-    if(_config->sampleCount)
+    bool clearHistory = _config->clearHistory &&
+        (*_config->clearHistory == ClearHistoryPolicy::OnAll ||
+         (sample->event == DataStorm::SampleEvent::Add && *_config->clearHistory == ClearHistoryPolicy::OnAdd) ||
+         (sample->event == DataStorm::SampleEvent::Remove && *_config->clearHistory == ClearHistoryPolicy::OnRemove) ||
+         (sample->event != DataStorm::SampleEvent::PartialUpdate &&
+          *_config->clearHistory == ClearHistoryPolicy::OnAllExceptPartialUpdate));
+
+    if(clearHistory || !replaceUnread(sample))
     {
-        if(*_config->sampleCount > 0)
+        if(_config->sampleCount)
         {
-            size_t count = _samples.size();
-            size_t maxCount = static_cast<size_t>(*_config->sampleCount);
-            if(count + 1 > maxCount)
+            if(*_config->sampleCount > 0)
             {
-                if(!_samples.empty())
+                size_t count = _samples.size();
+                size_t maxCount = static_cast<size_t>(*_config->sampleCount);
+                if(count + 1 > maxCount)
                 {
-                    _samples.pop_front();
+                    if(!_samples.empty())
+                    {
+                        _samples.pop_front();
+                    }
+                    assert(_samples.size() + 1 == maxCount);
                 }
-                assert(_samples.size() + 1 == maxCount);
+            }
+            else if(*_config->sampleCount == 0)
+            {
+                return; // Don't keep history
             }
         }
-        else if(*_config->sampleCount == 0)
+
+        if(clearHistory)
         {
-            return; // Don't keep history
+            _samples.clear();
         }
+        pushUnread(sample);
+        trimUnread();
     }
+    _last = sample;
+    _parent->_cond.notify_all();
+    notifyUnreadWaiters();
+}
 
-    if(_config->clearHistory &&
-       (*_config->clearHistory == ClearHistoryPolicy::OnAll ||
-        (sample->event == DataStorm::SampleEvent::Add && *_config->clearHistory == ClearHistoryPolicy::OnAdd) ||
-        (sample->event == DataStorm::SampleEvent::Remove && *_config->clearHistory == ClearHistoryPolicy::OnRemove) ||
-        (sample->event != DataStorm::SampleEvent::PartialUpdate &&
-         *_config->clearHistory == ClearHistoryPolicy::OnAllExceptPartialUpdate)))
+bool
+DataReaderI::replaceUnread(const shared_ptr<Sample>& sample)
+{
+    // Called with the topic mutex locked
+    if(_discardPolicy != DataStorm::DiscardPolicy::KeepLatestPerKey)
     {
-        _samples.clear();
+        return false;
+    }
+
+    //
+    // The unread samples are removed from the front of the queue (the key slots are rebuilt otherwise), the position
+    // of the front sample is the number of samples pushed minus the queue size. A key slot before the front sample
+    // is no longer queued.
+    //
+    auto front = _pushedCount - _samples.size();
+    auto p = _keySlots.find(sample->key);
+    if(p == _keySlots.end() || p->second < front)
+    {
+        return false;
+    }
+
+    auto& slot = _samples[p->second - front];
+    assert(slot->key == sample->key);
+    if(_traceLevels->data > 2)
+    {
+        Trace out(_traceLevels, _traceLevels->dataCat);
+        out << this << ": replaced unread sample " << slot->id << " with sample " << sample->id;
+    }
+    FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, slot->id);
+    slot = sample;
+    return true;
+}
+
+void
+DataReaderI::pushUnread(const shared_ptr<Sample>& sample)
+{
+    // Called with the topic mutex locked
+    if(_discardPolicy == DataStorm::DiscardPolicy::KeepLatestPerKey)
+    {
+        _keySlots[sample->key] = _pushedCount;
     }
     _samples.push_back(sample);
-    _last = sample;
-    _parent->_cond.notify_all();
+    ++_pushedCount;
+}
+
+void
+DataReaderI::rebuildKeySlots()
+{
+    //
+    // Called with the topic mutex locked once samples were removed from the middle of the queue, the remaining
+    // samples are given consecutive positions ending with the position of the last pushed sample.
+    //
+    if(_discardPolicy != DataStorm::DiscardPolicy::KeepLatestPerKey)
+    {
+        return;
+    }
+
+    _keySlots.clear();
+    auto front = _pushedCount - _samples.size();
+    for(size_t i = 0; i < _samples.size(); ++i)
+    {
+        _keySlots[_samples[i]->key] = front + i;
+    }
+}
+
+size_t
+DataReaderI::getUnreadLimit() const
+{
+    // Called with the topic mutex locked
+    auto limit = numeric_limits<size_t>::max();
+    if(_config->maxUnreadSamples)
+    {
+        limit = static_cast<size_t>(*_config->maxUnreadSamples);
+    }
+
+    // The size of the unread samples is estimated from the average encoded size of the received samples.
+    if(_config->maxUnreadBytes && _averageSampleSize > 0)
+    {
+        limit = min(limit, max(static_cast<size_t>(*_config->maxUnreadBytes) / _averageSampleSize, size_t(1)));
+    }
+    return limit;
+}
+
+void
+DataReaderI::trimUnread()
+{
+    // Called with the topic mutex locked
+    auto limit = getUnreadLimit();
+    while(_samples.size() > limit)
+    {
+        if(_traceLevels->data > 2)
+        {
+            Trace out(_traceLevels, _traceLevels->dataCat);
+            out << this << ": discarded unread sample " << _samples.front()->id << " (unread limit reached)";
+        }
+        incCounter(&SampleCounters::discardedFlowControl);
+        FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, _samples.front()->id);
+        _samples.pop_front();
+    }
+}
+
+void
+DataReaderI::grantCredit()
+{
+    // Called with the topic mutex locked
+    if(!_config->maxUnreadSamples && !_config->maxUnreadBytes)
+    {
+        return;
+    }
+
+    //
+    // The writers still have the credit granted with the last credit minus the samples received since. Credit is
+    // granted again once the application read at least half of the unread limit or all the unread samples, the
+    // writers are stopped right away if the estimated limit decreased below the number of unread samples.
+    //
+    auto limit = getUnreadLimit();
+    auto available = limit > _samples.size() ? limit - _samples.size() : 0;
+    auto remaining = _credit > _receivedSinceCredit ? _credit - _receivedSinceCredit : 0;
+    if(available == 0 ? remaining == 0 :
+       available < remaining + max(limit / 2, size_t(1)) && (!_samples.empty() || available <= remaining))
+    {
+        return;
+    }
+
+    _credit = available;
+    _receivedSinceCredit = 0;
+    if(_listeners.empty())
+    {
+        return;
+    }
+
+    // The available credit is shared by the writer sessions.
+    auto count = _listeners.size();
+    auto credit = min((available + count - 1) / count, static_cast<size_t>(numeric_limits<int>::max()));
+    if(_traceLevels->data > 2)
+    {
+        Trace out(_traceLevels, _traceLevels->dataCat);
+        out << this << ": granting credit " << credit << " to " << count << " sessions";
+    }
+    for(const auto& listener : _listeners)
+    {
+        auto session = Ice::uncheckedCast<PublisherSessionPrx>(listener.second.proxy);
+        session->creditAsync(_parent->getId(), getElementId(), listener.second.lastId, static_cast<int>(credit));
+    }
 }
 
 void
@@ -957,38 +1635,509 @@ DataWriterI::DataWriterI(TopicWriterI* topic,
                          long long int id,
                          const DataStorm::WriterConfig& config) :
     DataElementI(topic, name, id, config),
-    _parent(topic)
+    _parent(topic),
+    _async(config.async && *config.async),
+    _flowControlPolicy(config.flowControlPolicy ? *config.flowControlPolicy : DataStorm::FlowControlPolicy::Drop),
+    _maxBacklogSamples(config.maxBacklogSamples ? max(*config.maxBacklogSamples, 0) : 0),
+    _maxBacklogBytes(config.maxBacklogBytes ? max(*config.maxBacklogBytes, 0LL) : 0),
+    _slowConsumerPolicy(config.slowConsumerPolicy ? *config.slowConsumerPolicy : DataStorm::SlowConsumerPolicy::Drop),
+    _batch(config.batch && *config.batch),
+    _batchSize(static_cast<size_t>(config.batchSize && *config.batchSize > 0 ? *config.batchSize : 64 * 1024)),
+    _batchFlushInterval(config.batchFlushInterval && *config.batchFlushInterval > 0 ? *config.batchFlushInterval : 1),
+    _lane(config.lane ? max(*config.lane, 0) : 0),
+    _expiryTimer(0),
+    _batchBytes(0),
+    _batchTimer(0)
 {
     _config->priority = config.priority;
+    if(_lane > 0)
+    {
+        topic->getInstance()->getNode()->addLane(_lane);
+    }
+}
+
+DataStorm::ElementMetrics
+DataWriterI::getMetrics() const
+{
+    auto metrics = DataElementI::getMetrics();
+    metrics.historyDepth = static_cast<long long int>(_samples.size());
+    return metrics;
+}
+
+DataStorm::ElementDescription
+DataWriterI::describe() const
+{
+    auto description = DataElementI::describe();
+    description.config["flowControlPolicy"] = ::toString(_flowControlPolicy);
+    if(_maxBacklogSamples > 0)
+    {
+        description.config["maxBacklogSamples"] = to_string(_maxBacklogSamples);
+    }
+    if(_maxBacklogBytes > 0)
+    {
+        description.config["maxBacklogBytes"] = to_string(_maxBacklogBytes);
+    }
+    description.config["slowConsumerPolicy"] = ::toString(_slowConsumerPolicy);
+    if(_batch)
+    {
+        description.config["batchSize"] = to_string(_batchSize);
+        description.config["batchFlushInterval"] = to_string(_batchFlushInterval.count());
+    }
+    if(_lane > 0)
+    {
+        description.config["lane"] = to_string(_lane);
+    }
+    description.historyDepth = static_cast<long long int>(_samples.size());
+    return description;
 }
 
 void
-DataWriterI::init()
+DataWriterI::destroy()
 {
-    DataElementI::init();
-    _subscribers = Ice::uncheckedCast<DataStormContract::SubscriberSessionPrx>(_forwarder);
+    flushBatch(); // Send the batched samples before the writer is detached from the readers
+    DataElementI::destroy();
 }
 
 void
 DataWriterI::publish(const shared_ptr<Key>& key, const shared_ptr<Sample>& sample)
 {
-    lock_guard<mutex> lock(_parent->_mutex);
+    if(!_async)
+    {
+        publishSample(key, sample);
+    }
+    else if(_queue.push({ key, sample, nullptr }))
+    {
+        _parent->getInstance()->getPublishExecutor()->queue(static_pointer_cast<DataWriterI>(shared_from_this()));
+    }
+}
+
+void
+DataWriterI::flush(function<void()> flushed)
+{
+    if(!_async)
+    {
+        flushBatch();
+        flushed();
+    }
+    else if(_queue.push({ nullptr, nullptr, move(flushed) }))
+    {
+        _parent->getInstance()->getPublishExecutor()->queue(static_pointer_cast<DataWriterI>(shared_from_this()));
+    }
+}
+
+bool
+DataWriterI::publishQueued(size_t max)
+{
+    //
+    // Called by a sender thread, the queued samples are published in order. A sample which fails to be published
+    // (e.g. the partial update updater raised an exception) is traced and dropped, the sender thread keeps
+    // publishing the next samples.
+    //
+    auto more = _queue.consume([this](PublishQueue::Item& item)
+    {
+        try
+        {
+            if(item.sample)
+            {
+                publishSample(item.key, item.sample);
+            }
+            else
+            {
+                flushBatch();
+            }
+        }
+        catch(const std::exception& ex)
+        {
+            publishFailed(item, ex.what());
+        }
+        catch(...)
+        {
+            publishFailed(item, "unknown exception");
+        }
+
+        if(item.flushed)
+        {
+            item.flushed();
+        }
+    }, max);
+
+    try
+    {
+        flushBatch(); // The batched samples are flushed at the end of each burst
+    }
+    catch(const std::exception& ex)
+    {
+        publishFailed(PublishQueue::Item(), ex.what());
+    }
+    catch(...)
+    {
+        publishFailed(PublishQueue::Item(), "unknown exception");
+    }
+    return more;
+}
+
+void
+DataWriterI::publishFailed(const PublishQueue::Item& item, const string& reason)
+{
+    Warning out(_traceLevels);
+    if(item.sample)
+    {
+        out << this << ": failed to publish queued sample, the sample is dropped:\n" << reason;
+    }
+    else
+    {
+        out << this << ": failed to flush the batched samples:\n" << reason;
+    }
+}
+
+void
+DataWriterI::discardQueued()
+{
+    // Called once the publish executor is destroyed, the flush callbacks are still called to not block callers
+    auto discard = [](PublishQueue::Item& item)
+    {
+        if(item.flushed)
+        {
+            item.flushed();
+        }
+    };
+    while(_queue.consume(discard, numeric_limits<size_t>::max()))
+    {
+    }
+}
+
+void
+DataWriterI::publishSample(const shared_ptr<Key>& key, const shared_ptr<Sample>& sample)
+{
+    //
+    // The publications of the writer are serialized with the publish mutex. The sample is encoded before locking
+    // the topic and sent once it's unlocked, only the sample numbering and the history update lock the topic. A
+    // reader attached in between receives the sample with its initialization samples and with this send, the
+    // subscriber session drops the samples whose id isn't greater than the last initialization sample id.
+    //
+    unique_lock<mutex> publishLock(_publishMutex);
+    Topic::Updater updater;
+    shared_ptr<Sample> previous;
     if(sample->event == DataStorm::SampleEvent::PartialUpdate)
     {
         assert(!sample->hasValue());
-        _parent->getUpdater(sample->tag)(_last, sample, _parent->getInstance()->getCommunicator());
+        {
+            lock_guard<mutex> lock(_parent->_mutex);
+            updater = _parent->getUpdater(sample->tag);
+        }
+        previous = _last; // _last is only set by publish
+        updater(previous, sample, _parent->getInstance()->getCommunicator());
+    }
+    auto dataSample = encode(key, sample);
+
+    vector<Target> targets;
+    unique_lock<mutex> sendLock(_sendMutex, defer_lock);
+    {
+        unique_lock<mutex> lock(_parent->_mutex);
+        if(_flowControlPolicy == DataStorm::FlowControlPolicy::Block)
+        {
+            //
+            // Wait for the readers interested in the sample to have credit or to disconnect. The publish mutex isn't
+            // held while waiting, the partial update is applied again if another publication updated the value.
+            //
+            while(!_destroyed && !_parent->getInstance()->isShutdown() && !hasCredit(sample))
+            {
+                publishLock.unlock();
+                _parent->_cond.wait(lock);
+                lock.unlock();
+                publishLock.lock();
+                if(updater && _last != previous)
+                {
+                    previous = _last;
+                    updater(previous, sample, _parent->getInstance()->getCommunicator());
+                }
+                lock.lock();
+            }
+        }
+        sample->id = ++_parent->_nextSampleId;
+        sample->timestamp = chrono::system_clock::now();
+        incCounter(&SampleCounters::published);
+        FlightRecorder::record(FlightEvent::Published, _parent->getId(), _id, sample->id);
+
+        if(_traceLevels->data > 2)
+        {
+            Trace out(_traceLevels, _traceLevels->dataCat);
+            out << this << ": publishing sample " << sample->id << " listeners=" << _listenerCount;
+        }
+        targets = getTargets(sample);
+        addToHistory(sample);
+
+        // The send mutex is locked before the topic mutex is released, the samples are sent in the id order.
+        sendLock.lock();
+    }
+
+    dataSample.id = sample->id;
+    dataSample.timestamp = chrono::time_point_cast<chrono::microseconds>(sample->timestamp).time_since_epoch().count();
+
+    auto p = stable_partition(targets.begin(), targets.end(), [](const Target& target) { return !target.fullUpdate; });
+    if(p != targets.end())
+    {
+        // The partial update is sent as a full update to the readers which missed a previous sample of the key
+        vector<Target> fullTargets(p, targets.end());
+        targets.erase(p, targets.end());
+        auto fullSample = dataSample;
+        fullSample.tag = 0;
+        fullSample.event = DataStorm::SampleEvent::Update;
+        fullSample.value = sample->encodeValue(getCommunicator());
+        send(fullSample, fullTargets);
+        if(_batch)
+        {
+            queueBatch(fullTargets, fullSample.value.size());
+        }
+    }
+
+    send(dataSample, targets);
+    if(_batch)
+    {
+        queueBatch(targets, dataSample.value.size());
+    }
+}
+
+void
+DataWriterI::credit(const shared_ptr<SessionI>& session, const string& facet, long long int lastId, int credit)
+{
+    // No locking necessary, called by the session with the mutex locked
+    auto p = _listeners.find({ session, facet });
+    if(p == _listeners.end() || !p->second.flowControl)
+    {
+        return;
     }
 
-    sample->id = ++_parent->_nextSampleId;
-    sample->timestamp = chrono::system_clock::now();
+    // The samples up to the last sample received by the reader are no longer in flight.
+    auto& unacknowledged = p->second.unacknowledged;
+    while(!unacknowledged.empty() && unacknowledged.front() <= lastId)
+    {
+        unacknowledged.pop_front();
+    }
+    p->second.credit = credit;
 
     if(_traceLevels->data > 2)
     {
         Trace out(_traceLevels, _traceLevels->dataCat);
-        out << this << ": publishing sample " << sample->id << " listeners=" << _listenerCount;
+        out << this << ": received credit " << credit << " (in flight = " << unacknowledged.size() << ")";
     }
-    send(key, sample);
+    if(_flowControlPolicy == DataStorm::FlowControlPolicy::Block)
+    {
+        _parent->_cond.notify_all(); // Wake up the publishers waiting for credit
+    }
+}
 
+shared_ptr<SessionPrx>
+DataWriterI::getSendProxy(const ListenerKey& listenerKey, Listener& listener) const
+{
+    // Called with the topic mutex locked
+    auto proxy = listener.proxy;
+    if(_lane > 0)
+    {
+        //
+        // The listener connection is chosen when the first sample is sent: the lane connection if it's established
+        // and attached to the peer session, the session connection otherwise. The listener doesn't switch to the
+        // lane connection afterwards, this would reorder the samples sent over both connections. It switches back
+        // to the session connection if the lane connection is lost. The samples received over the lane before the
+        // initialization samples sent over the session connection are kept by the peer until it's initialized.
+        //
+        auto lane = listenerKey.session->getLaneProxy(_lane);
+        if(!listener.laneChosen)
+        {
+            listener.laneChosen = true;
+            if(lane)
+            {
+                auto laneProxy = listenerKey.facet.empty() ? lane : lane->ice_facet(listenerKey.facet);
+                listener.lane = lane;
+                listener.laneProxy = Ice::uncheckedCast<SessionPrx>(laneProxy);
+                listener.batchProxy = nullptr;
+            }
+        }
+        else if(listener.lane && lane != listener.lane)
+        {
+            listener.lane = nullptr;
+            listener.laneProxy = nullptr;
+            listener.batchProxy = nullptr;
+        }
+        if(listener.laneProxy)
+        {
+            proxy = listener.laneProxy;
+        }
+    }
+
+    if((_maxBacklogSamples > 0 || _maxBacklogBytes > 0) && proxy == listener.proxy &&
+       NodeSessionI::isSessionForwarder(proxy))
+    {
+        //
+        // The oneway invocation of a collocated forwarder completes before the sample is written to the node
+        // session connection, the forwarder only acknowledges a twoway invocation once it's written. These
+        // samples aren't batched, the flush of the collocated batch would also complete immediately.
+        //
+        if(!listener.twowayProxy)
+        {
+            listener.twowayProxy = proxy->ice_twoway();
+        }
+        return listener.twowayProxy;
+    }
+    else if(!_batch)
+    {
+        return proxy;
+    }
+    else if(!listener.batchProxy)
+    {
+        listener.batchProxy = proxy->ice_batchOneway();
+    }
+    return listener.batchProxy;
+}
+
+void
+DataWriterI::queueBatch(const vector<Target>& targets, size_t size)
+{
+    lock_guard<mutex> batchLock(_batchMutex);
+    bool backlog = _maxBacklogSamples > 0 || _maxBacklogBytes > 0;
+    for(const auto& target : targets)
+    {
+        if(!target.proxy->ice_isBatchOneway())
+        {
+            continue; // Sent by send()
+        }
+
+        auto p = find_if(_batchProxies.begin(), _batchProxies.end(),
+                         [&target](const BatchProxy& batchProxy) { return batchProxy.proxy == target.proxy; });
+        if(p == _batchProxies.end())
+        {
+            _batchProxies.push_back({ target.proxy, target.backlog, 0, 0 });
+            p = _batchProxies.end() - 1;
+        }
+        if(backlog)
+        {
+            // The batched sample is in the listener backlog until flushBatchImpl writes the batch
+            ++p->samples;
+            p->bytes += static_cast<long long int>(size);
+            ++target.backlog->samples;
+            target.backlog->bytes += static_cast<long long int>(size);
+        }
+        _batchBytes += size;
+    }
+
+    if(_batchBytes >= _batchSize)
+    {
+        flushBatchImpl();
+    }
+    else if(!_batchTimer && !_batchProxies.empty())
+    {
+        weak_ptr<DataElementI> self = shared_from_this();
+        _batchTimer = _parent->getInstance()->getTimer()->schedule(_batchFlushInterval, [this, self]
+        {
+            auto element = self.lock();
+            if(element)
+            {
+                lock_guard<mutex> batchLock(_batchMutex);
+                _batchTimer = 0;
+                flushBatchImpl();
+            }
+        });
+    }
+}
+
+void
+DataWriterI::flushBatch()
+{
+    if(_batch)
+    {
+        lock_guard<mutex> batchLock(_batchMutex);
+        flushBatchImpl();
+    }
+}
+
+void
+DataWriterI::flushBatchImpl()
+{
+    // Called with the batch mutex locked
+    if(_batchTimer)
+    {
+        _parent->getInstance()->getTimer()->cancel(_batchTimer);
+        _batchTimer = 0;
+    }
+    for(const auto& batchProxy : _batchProxies)
+    {
+        if(batchProxy.samples > 0)
+        {
+            auto backlog = batchProxy.backlog;
+            auto samples = batchProxy.samples;
+            auto bytes = batchProxy.bytes;
+            auto done = make_shared<atomic_flag>();
+            done->clear();
+            auto release = [backlog, samples, bytes, done]()
+            {
+                if(!done->test_and_set())
+                {
+                    backlog->samples -= samples;
+                    backlog->bytes -= bytes;
+                }
+            };
+            batchProxy.proxy->ice_flushBatchRequestsAsync([release](exception_ptr) { release(); },
+                                                          [release](bool) { release(); });
+        }
+        else
+        {
+            batchProxy.proxy->ice_flushBatchRequestsAsync();
+        }
+    }
+    _batchProxies.clear();
+    _batchBytes = 0;
+}
+
+bool
+DataWriterI::checkSlowConsumer(const ListenerKey& listenerKey, Listener& listener)
+{
+    // Called with the topic mutex locked, returns true if the listener is a slow consumer
+    if(_maxBacklogSamples == 0 && _maxBacklogBytes == 0)
+    {
+        return false;
+    }
+
+    auto samples = listener.backlog->samples.load();
+    auto bytes = listener.backlog->bytes.load();
+    bool slow = (_maxBacklogSamples > 0 && samples > _maxBacklogSamples) ||
+                (_maxBacklogBytes > 0 && bytes > _maxBacklogBytes);
+    if(slow && !listener.slow)
+    {
+        incCounter(&SampleCounters::slowConsumers);
+        if(_traceLevels->data > 0)
+        {
+            Trace out(_traceLevels, _traceLevels->dataCat);
+            out << this << ": session `" << listenerKey.session->getId() << "' is a slow consumer (backlog = "
+                << samples << " samples, " << bytes << " bytes)";
+        }
+    }
+    listener.slow = slow;
+
+    if(slow && _slowConsumerPolicy == DataStorm::SlowConsumerPolicy::Disconnect && !listener.disconnecting)
+    {
+        //
+        // The connection is closed by the timer thread, the session mutex can't be locked with the topic mutex
+        // locked. The session is re-established with a new listener once the peer reconnects.
+        //
+        listener.disconnecting = true;
+        auto session = listenerKey.session;
+        _parent->getInstance()->getTimer()->schedule(chrono::milliseconds(0), [session]
+        {
+            auto connection = session->getConnection();
+            if(connection)
+            {
+                connection->close(Ice::ConnectionClose::Forcefully);
+            }
+        });
+    }
+    return slow;
+}
+
+void
+DataWriterI::addToHistory(const shared_ptr<Sample>& sample)
+{
+    // Called with the topic mutex locked
+    _historyChunk = HistoryChunk();
     if(_config->sampleLifetime && *_config->sampleLifetime > 0)
     {
         cleanOldSamples(_samples, sample->timestamp, *_config->sampleLifetime);
@@ -1021,6 +2170,58 @@ DataWriterI::publish(const shared_ptr<Key>& key, const shared_ptr<Sample>& sampl
     assert(sample->key);
     _samples.push_back(sample);
     _last = sample;
+
+    if(!_expiryTimer && _config->sampleLifetime && *_config->sampleLifetime > 0)
+    {
+        scheduleExpiry();
+    }
+}
+
+void
+DataWriterI::scheduleExpiry()
+{
+    // Called with the topic mutex locked
+    assert(!_samples.empty() && !_expiryTimer);
+    auto lifetime = chrono::milliseconds(*_config->sampleLifetime);
+    auto delay = chrono::duration_cast<chrono::milliseconds>(_samples.front()->timestamp + lifetime -
+                                                             chrono::system_clock::now());
+
+    //
+    // A single timer is armed for the oldest sample of the history, it's armed again for the next oldest sample
+    // once the expired samples are removed. This releases the samples of writers which no longer publish.
+    //
+    weak_ptr<DataElementI> self = shared_from_this();
+    _expiryTimer = _parent->getInstance()->getTimer()->schedule(max(delay, chrono::milliseconds(0)), [this, self]
+    {
+        auto element = self.lock();
+        if(!element)
+        {
+            return;
+        }
+        lock_guard<mutex> lock(_parent->_mutex);
+        _expiryTimer = 0;
+        if(_destroyed)
+        {
+            return;
+        }
+        cleanOldSamples(_samples, chrono::system_clock::now(), *_config->sampleLifetime);
+        _historyChunk = HistoryChunk();
+        if(!_samples.empty())
+        {
+            scheduleExpiry();
+        }
+    });
+}
+
+void
+DataWriterI::cancelExpiry()
+{
+    // Called with the topic mutex locked
+    if(_expiryTimer)
+    {
+        _parent->getInstance()->getTimer()->cancel(_expiryTimer);
+        _expiryTimer = 0;
+    }
 }
 
 KeyDataReaderI::KeyDataReaderI(TopicReaderI* topic,
@@ -1040,10 +2241,10 @@ KeyDataReaderI::KeyDataReaderI(TopicReaderI* topic,
     }
 
     //
-    // If sample filtering is enabled, ensure the updates are received using a session
-    // facet specific to this reader.
+    // If sample filtering, conflation or flow control is enabled, ensure the updates are received using a
+    // session facet specific to this reader.
     //
-    if(_config->sampleFilter)
+    if(_config->sampleFilter || _config->maxUpdateRate || _config->maxUnreadSamples || _config->maxUnreadBytes)
     {
         ostringstream os;
         os << "fa" << _id;
@@ -1110,6 +2311,12 @@ KeyDataReaderI::matchKey(const shared_ptr<Key>& key) const
     return _keys.empty() || find(_keys.begin(), _keys.end(), key) != _keys.end();
 }
 
+long long int
+KeyDataReaderI::getElementId() const
+{
+    return _keys.empty() ? -_id : _id;
+}
+
 KeyDataWriterI::KeyDataWriterI(TopicWriterI* topic,
                                const string& name,
                                long long int id,
@@ -1133,6 +2340,7 @@ KeyDataWriterI::destroyImpl()
         Trace out(_traceLevels, _traceLevels->dataCat);
         out << this << ": destroyed key writer";
     }
+    cancelExpiry();
     try
     {
         _forwarder->detachElements(_parent->getId(), { _keys.empty() ? -_id : _id });
@@ -1210,7 +2418,12 @@ KeyDataWriterI::getSamples(const shared_ptr<Key>& key,
 
     if(_config->sampleLifetime && *_config->sampleLifetime > 0)
     {
+        auto size = _samples.size();
         cleanOldSamples(_samples, now, *_config->sampleLifetime);
+        if(_samples.size() != size)
+        {
+            _historyChunk = HistoryChunk();
+        }
     }
 
     chrono::time_point<chrono::system_clock> staleTime = chrono::time_point<chrono::system_clock>::min();
@@ -1219,6 +2432,27 @@ KeyDataWriterI::getSamples(const shared_ptr<Key>& key,
         staleTime = now - chrono::milliseconds(*config->sampleLifetime);
     }
 
+    //
+    // The history chunk is shared by the readers with the same key, sample filter, sample count, clear history
+    // policy and last sample ID. It isn't used for readers with a sample lifetime, their samples depend on the
+    // attach time.
+    //
+    int sampleCount = config->sampleCount && *config->sampleCount > 0 ? *config->sampleCount : 0;
+    int clearHistory = config->clearHistory ? static_cast<int>(*config->clearHistory) : -1;
+    bool compositeUpdates = config->compositeUpdates && *config->compositeUpdates;
+    bool shared = staleTime == chrono::time_point<chrono::system_clock>::min();
+    if(shared &&
+       _historyChunk.valid &&
+       _historyChunk.key == key &&
+       _historyChunk.sampleFilter == sampleFilter &&
+       _historyChunk.sampleCount == sampleCount &&
+       _historyChunk.clearHistory == clearHistory &&
+       _historyChunk.compositeUpdates == compositeUpdates &&
+       _historyChunk.lastId == lastId)
+    {
+        return _historyChunk.samples;
+    }
+
     shared_ptr<Sample> first;
     for(auto p = _samples.rbegin(); p != _samples.rend(); ++p)
     {
@@ -1235,6 +2469,14 @@ KeyDataWriterI::getSamples(const shared_ptr<Key>& key,
         {
             first = *p;
             samples.samples.push_front(toSample(*p, getCommunicator(), _keys.empty()));
+            if(!compositeUpdates && (*p)->event == DataStorm::SampleEvent::PartialUpdate && !(*p)->tag)
+            {
+                // The reader doesn't apply composite partial updates, it's sent the full value instead
+                auto& sample = samples.samples.front();
+                sample.tag = 0;
+                sample.event = DataStorm::SampleEvent::Update;
+                sample.value = (*p)->encodeFullValue(getCommunicator());
+            }
             if(config->sampleCount &&
                *config->sampleCount > 0 && static_cast<size_t>(*config->sampleCount) == samples.samples.size())
             {
@@ -1264,33 +2506,332 @@ KeyDataWriterI::getSamples(const shared_ptr<Key>& key,
                 chrono::time_point_cast<chrono::microseconds>(first->timestamp).time_since_epoch().count(),
                 0,
                 DataStorm::SampleEvent::Update,
-                first->encodeValue(getCommunicator()) };
+                first->encodeFullValue(getCommunicator()) };
         }
     }
+
+    if(shared)
+    {
+        _historyChunk.valid = true;
+        _historyChunk.key = key;
+        _historyChunk.sampleFilter = sampleFilter;
+        _historyChunk.sampleCount = sampleCount;
+        _historyChunk.clearHistory = clearHistory;
+        _historyChunk.compositeUpdates = compositeUpdates;
+        _historyChunk.lastId = lastId;
+        _historyChunk.samples = samples;
+    }
     return samples;
 }
 
-void
-KeyDataWriterI::send(const shared_ptr<Key>& key, const shared_ptr<Sample>& sample) const
+DataSample
+KeyDataWriterI::encode(const shared_ptr<Key>& key, const shared_ptr<Sample>& sample) const
 {
     assert(key || _keys.size() == 1);
-    _sample = sample;
-    _sample->key = key ? key : _keys[0];
-    _subscribers->s(_parent->getId(), _keys.empty() ? -_id : _id, toSample(sample, getCommunicator(), _keys.empty()));
-    _sample = nullptr;
+    sample->key = key ? key : _keys[0];
+    return toSample(sample, getCommunicator(), _keys.empty());
 }
 
-void
-KeyDataWriterI::forward(const Ice::ByteSeq& inEncaps, const Ice::Current& current) const
+vector<DataWriterI::Target>
+KeyDataWriterI::getTargets(const shared_ptr<Sample>& sample)
 {
-    for(const auto& listener : _listeners)
+    // Called with the topic mutex locked
+    vector<Target> targets;
+    targets.reserve(_listeners.size());
+    for(auto& listener : _listeners)
     {
         // If there's at least one subscriber interested in the update (check the key if any writer)
-        if(!_sample || listener.second.matchOne(_sample, _keys.empty()))
+        if(listener.second.matchOne(sample, _keys.empty()))
+        {
+            if(!conflate(listener.first, listener.second, sample))
+            {
+                continue;
+            }
+
+            if(checkSlowConsumer(listener.first, listener.second))
+            {
+                auto& conflations = listener.second.conflations;
+                if(_slowConsumerPolicy != DataStorm::SlowConsumerPolicy::Conflate ||
+                   (sample->event != DataStorm::SampleEvent::Add && sample->event != DataStorm::SampleEvent::Remove))
+                {
+                    incCounter(&SampleCounters::discardedSlowConsumer);
+                    FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, sample->id);
+                    if(_slowConsumerPolicy == DataStorm::SlowConsumerPolicy::Conflate)
+                    {
+                        // The latest sample of the key is sent once the listener backlog is below the limits.
+                        auto& conflation = conflations[sample->key];
+                        conflation.pending = sample;
+                        if(!conflation.timer)
+                        {
+                            scheduleConflated(listener.first, conflation, sample->key, slowConsumerRetryDelay);
+                        }
+                    }
+                    else
+                    {
+                        listener.second.droppedKeys.insert(sample->key);
+                    }
+                    continue;
+                }
+
+                // Add and Remove samples are sent to slow consumers, they supersede the pending sample.
+                auto q = conflations.find(sample->key);
+                if(q != conflations.end() && q->second.timer)
+                {
+                    _parent->getInstance()->getTimer()->cancel(q->second.timer);
+                    q->second.timer = 0;
+                    q->second.pending = nullptr;
+                }
+            }
+
+            if(!listener.second.hasCredit())
+            {
+                incCounter(&SampleCounters::discardedFlowControl);
+                FlightRecorder::record(FlightEvent::Discarded, _parent->getId(), _id, sample->id);
+                listener.second.droppedKeys.insert(sample->key);
+                continue;
+            }
+            else if(listener.second.flowControl)
+            {
+                listener.second.unacknowledged.push_back(sample->id);
+            }
+
+            //
+            // The reader value diverged if a sample of the key was dropped, the next sample of the key resyncs it.
+            // A partial update is sent as a full update. A composite partial update is also sent as a full update
+            // to listeners with readers which don't apply composite partial updates.
+            //
+            bool fullUpdate = false;
+            if(listener.second.droppedKeys.erase(sample->key) > 0 ||
+               (!sample->tag && !listener.second.compositeUpdates))
+            {
+                fullUpdate = sample->event == DataStorm::SampleEvent::PartialUpdate;
+            }
+            targets.push_back({ listener.first.session,
+                                getSendProxy(listener.first, listener.second),
+                                listener.second.backlog,
+                                fullUpdate });
+        }
+        else
         {
-            listener.second.proxy->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
+            incCounter(&SampleCounters::filtered);
         }
     }
+    return targets;
+}
+
+bool
+KeyDataWriterI::hasCredit(const shared_ptr<Sample>& sample) const
+{
+    // Called with the topic mutex locked
+    for(const auto& listener : _listeners)
+    {
+        if(!listener.second.hasCredit() && listener.second.matchOne(sample, _keys.empty()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+KeyDataWriterI::conflate(const ListenerKey& listenerKey, Listener& listener, const shared_ptr<Sample>& sample)
+{
+    // Called with the topic mutex locked, returns true if the sample must be sent now
+    if(listener.updateInterval == chrono::microseconds::zero())
+    {
+        return true;
+    }
+
+    auto now = chrono::steady_clock::now();
+    if(sample->event == DataStorm::SampleEvent::Remove)
+    {
+        // The Remove sample is sent right away, the conflation state of the removed key is discarded.
+        auto p = listener.conflations.find(sample->key);
+        if(p != listener.conflations.end())
+        {
+            if(p->second.timer)
+            {
+                _parent->getInstance()->getTimer()->cancel(p->second.timer);
+            }
+            listener.conflations.erase(p);
+        }
+        return true;
+    }
+
+    auto& conflation = listener.conflations[sample->key];
+    if(sample->event == DataStorm::SampleEvent::Add)
+    {
+        // Add samples are sent right away, they supersede the pending sample.
+        if(conflation.timer)
+        {
+            _parent->getInstance()->getTimer()->cancel(conflation.timer);
+            conflation.timer = 0;
+        }
+        conflation.pending = nullptr;
+        conflation.next = now + listener.updateInterval;
+        return true;
+    }
+    else if(!conflation.pending && now >= conflation.next)
+    {
+        conflation.next = now + listener.updateInterval;
+        return true;
+    }
+
+    //
+    // The listener already received a sample for this key during the current interval, the sample replaces the
+    // pending sample and is sent at the end of the interval unless a newer sample replaces it.
+    //
+    conflation.pending = sample;
+    if(!conflation.timer)
+    {
+        auto delay = chrono::duration_cast<chrono::milliseconds>(conflation.next - now) + chrono::milliseconds(1);
+        scheduleConflated(listenerKey, conflation, sample->key, delay);
+    }
+    return false;
+}
+
+void
+KeyDataWriterI::scheduleConflated(const ListenerKey& listenerKey,
+                                  Conflation& conflation,
+                                  const shared_ptr<Key>& key,
+                                  chrono::milliseconds delay)
+{
+    // Called with the topic mutex locked
+    weak_ptr<DataElementI> self = shared_from_this();
+    conflation.timer = _parent->getInstance()->getTimer()->schedule(delay, [this, self, listenerKey, key]
+    {
+        auto element = self.lock();
+        if(element)
+        {
+            sendConflated(listenerKey, key);
+        }
+    });
+}
+
+void
+KeyDataWriterI::sendConflated(const ListenerKey& listenerKey, const shared_ptr<Key>& key)
+{
+    //
+    // Called by the timer thread which doesn't lock the publish mutex. The target and the sample are computed with
+    // the topic mutex locked and the send mutex is locked before the topic mutex is released, the pending sample is
+    // therefore sent before the samples of the key published after it.
+    //
+    shared_ptr<Sample> sample;
+    vector<Target> targets;
+    DataSample dataSample;
+    unique_lock<mutex> sendLock(_sendMutex, defer_lock);
+    {
+        lock_guard<mutex> lock(_parent->_mutex);
+        if(_destroyed)
+        {
+            return;
+        }
+        auto p = _listeners.find(listenerKey);
+        if(p == _listeners.end())
+        {
+            return;
+        }
+        auto q = p->second.conflations.find(key);
+        if(q == p->second.conflations.end() || !q->second.pending)
+        {
+            return;
+        }
+        else if(_slowConsumerPolicy == DataStorm::SlowConsumerPolicy::Conflate &&
+                checkSlowConsumer(listenerKey, p->second))
+        {
+            scheduleConflated(listenerKey, q->second, key, slowConsumerRetryDelay); // Still too slow, retry later
+            return;
+        }
+        sample = move(q->second.pending);
+        q->second.timer = 0;
+        q->second.next = chrono::steady_clock::now() + p->second.updateInterval;
+        if(p->second.flowControl)
+        {
+            // The conflated sample is sent even without credit, it's at most one sample per key and interval.
+            p->second.unacknowledged.push_back(sample->id);
+        }
+        p->second.droppedKeys.erase(sample->key);
+        targets.push_back({ listenerKey.session, getSendProxy(listenerKey, p->second), p->second.backlog, false });
+        dataSample = toSample(sample, getCommunicator(), _keys.empty());
+        sendLock.lock();
+    }
+
+    //
+    // The partial updates published during the interval weren't sent, a pending partial update is sent as a full
+    // update with the value computed by the writer.
+    //
+    if(sample->event == DataStorm::SampleEvent::PartialUpdate)
+    {
+        dataSample.tag = 0;
+        dataSample.event = DataStorm::SampleEvent::Update;
+        dataSample.value = sample->encodeValue(getCommunicator());
+    }
+    send(dataSample, targets);
+    if(_batch)
+    {
+        queueBatch(targets, dataSample.value.size());
+    }
+}
+
+void
+KeyDataWriterI::send(const DataSample& sample, const vector<Target>& targets) const
+{
+    if(targets.empty())
+    {
+        return;
+    }
+
+    // The sample is marshaled once, the same encapsulation is sent to each target.
+    Ice::OutputStream stream(getCommunicator());
+    stream.startEncapsulation();
+    stream.writeAll(_parent->getId(), _keys.empty() ? -_id : _id, sample);
+    stream.endEncapsulation();
+    Ice::ByteSeq inEncaps;
+    stream.finished(inEncaps);
+
+    auto size = static_cast<long long int>(inEncaps.size());
+    for(const auto& target : targets)
+    {
+        if((_maxBacklogSamples > 0 || _maxBacklogBytes > 0) && !target.proxy->ice_isBatchOneway())
+        {
+            //
+            // The sample is in the listener backlog until it's written to the connection or the invocation fails.
+            // A twoway invocation (through a node session forwarder) completes with the response instead, the sent
+            // callback is also called for it and an exception can follow. The backlog is released only once.
+            // Batched samples are accounted for by queueBatch.
+            //
+            auto backlog = target.backlog;
+            ++backlog->samples;
+            backlog->bytes += size;
+            auto released = make_shared<atomic_flag>();
+            released->clear();
+            auto done = [backlog, size, released]()
+            {
+                if(!released->test_and_set())
+                {
+                    --backlog->samples;
+                    backlog->bytes -= size;
+                }
+            };
+            bool twoway = target.proxy->ice_isTwoway();
+            target.proxy->ice_invokeAsync("s", Ice::OperationMode::Normal, inEncaps,
+                                          [done](bool, const vector<Ice::Byte>&) { done(); },
+                                          [done](exception_ptr) { done(); },
+                                          [done, twoway](bool)
+                                          {
+                                              if(!twoway)
+                                              {
+                                                  done();
+                                              }
+                                          });
+        }
+        else
+        {
+            target.proxy->ice_invokeAsync("s", Ice::OperationMode::Normal, inEncaps);
+        }
+        target.session->sampleSent(inEncaps.size());
+        FlightRecorder::record(FlightEvent::Sent, _parent->getId(), _id, sample.id);
+    }
 }
 
 FilteredDataReaderI::FilteredDataReaderI(TopicReaderI* topic,
@@ -1310,10 +2851,10 @@ FilteredDataReaderI::FilteredDataReaderI(TopicReaderI* topic,
     }
 
     //
-    // If sample filtering is enabled, ensure the updates are received using a session
-    // facet specific to this reader.
+    // If sample filtering, conflation or flow control is enabled, ensure the updates are received using a
+    // session facet specific to this reader.
     //
-    if(_config->sampleFilter)
+    if(_config->sampleFilter || _config->maxUpdateRate || _config->maxUnreadSamples || _config->maxUnreadBytes)
     {
         ostringstream os;
         os << "fa" << _id;
@@ -1370,3 +2911,9 @@ FilteredDataReaderI::matchKey(const shared_ptr<Key>& key) const
 {
     return _filter->match(key);
 }
+
+long long int
+FilteredDataReaderI::getElementId() const
+{
+    return -_id;
+}
@@ -6,8 +6,18 @@
 #include <DataStorm/InternalI.h>
 #include <DataStorm/ForwarderManager.h>
 #include <DataStorm/Contract.h>
-
+#include <DataStorm/LatencyHistogram.h>
+#include <DataStorm/Admin.h>
+#include <DataStorm/Metrics.h>
+#include <DataStorm/Timer.h>
+#include <DataStorm/PublishExecutor.h>
+#include <DataStorm/Notifier.h>
+
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <limits>
+#include <unordered_map>
 
 namespace DataStormI
 {
@@ -19,7 +29,22 @@ class TopicWriterI;
 class CallbackExecutor;
 class TraceLevels;
 
-class DataElementI : virtual public DataElement, public std::enable_shared_from_this<DataElementI>
+//
+// Sample counters of data elements and topics. The counters are updated with the topic mutex locked.
+//
+struct SampleCounters
+{
+    long long int published = 0;
+    long long int queued = 0;
+    long long int discardedSendTime = 0;
+    long long int discardedPriority = 0;
+    long long int discardedFlowControl = 0;
+    long long int discardedSlowConsumer = 0;
+    long long int slowConsumers = 0;
+    long long int filtered = 0;
+};
+
+class DataElementI : virtual public DataElement, public Forwarder, public std::enable_shared_from_this<DataElementI>
 {
 protected:
 
@@ -30,7 +55,8 @@ protected:
                    const std::shared_ptr<Filter>& sampleFilter,
                    const std::string& name,
                    int priority) :
-            id(id), filter(filter), sampleFilter(sampleFilter), name(name), priority(priority)
+            id(id), filter(filter), sampleFilter(sampleFilter), name(name), priority(priority), updateInterval(0),
+            compositeUpdates(false)
         {
         }
 
@@ -42,9 +68,34 @@ protected:
         std::shared_ptr<Filter> sampleFilter;
         std::string name;
         int priority;
+        std::chrono::microseconds updateInterval;
+        bool compositeUpdates;
     };
 
-private:
+    //
+    // The conflation state of a key for a listener with a maximum update rate. The latest sample published
+    // before the end of the update interval is kept pending and sent by a timer once the interval elapsed.
+    //
+    struct Conflation
+    {
+        std::chrono::steady_clock::time_point next;
+        std::shared_ptr<Sample> pending;
+        Timer::TimerId timer = 0;
+    };
+
+    //
+    // The samples sent to a listener and not yet written to its connection. The counters are decremented by the
+    // sent callbacks of the invocations, without the topic mutex locked.
+    //
+    struct Backlog
+    {
+        Backlog() : samples(0), bytes(0)
+        {
+        }
+
+        std::atomic<long long int> samples;
+        std::atomic<long long int> bytes;
+    };
 
     struct ListenerKey
     {
@@ -68,7 +119,16 @@ private:
     struct Listener
     {
         Listener(const std::shared_ptr<DataStormContract::SessionPrx>& proxy, const std::string& facet) :
-            proxy(facet.empty() ? proxy : Ice::uncheckedCast<DataStormContract::SessionPrx>(proxy->ice_facet(facet)))
+            proxy(facet.empty() ? proxy : Ice::uncheckedCast<DataStormContract::SessionPrx>(proxy->ice_facet(facet))),
+            updateInterval(0),
+            compositeUpdates(false),
+            flowControl(false),
+            credit(0),
+            lastId(0),
+            backlog(std::make_shared<Backlog>()),
+            slow(false),
+            disconnecting(false),
+            laneChosen(false)
         {
         }
 
@@ -105,6 +165,30 @@ private:
             return p->second;
         }
 
+        void addConfig(const std::shared_ptr<Subscriber>& subscriber,
+                       const std::shared_ptr<DataStormContract::ElementConfig>& config)
+        {
+            int maxUpdateRate = config->maxUpdateRate ? *config->maxUpdateRate : 0;
+            subscriber->updateInterval = std::chrono::microseconds(maxUpdateRate > 0 ? 1000000 / maxUpdateRate : 0);
+            subscriber->compositeUpdates = config->compositeUpdates && *config->compositeUpdates;
+            computeUpdateInterval();
+            computeCompositeUpdates();
+
+            //
+            // Readers with unread limits use a dedicated facet, the flow control is only enabled if the reader
+            // is the only subscriber of the listener. The initial credit is the reader maximum number of unread
+            // samples.
+            //
+            flowControl = subscribers.size() == 1 && (config->maxUnreadSamples || config->maxUnreadBytes);
+            credit = config->maxUnreadSamples ? *config->maxUnreadSamples : std::numeric_limits<int>::max();
+            unacknowledged.clear();
+        }
+
+        bool hasCredit() const
+        {
+            return !flowControl || unacknowledged.size() < static_cast<size_t>(credit);
+        }
+
         std::shared_ptr<Subscriber> get(long long int topicId, long long int elementId)
         {
             return subscribers.find(std::make_pair(topicId, elementId))->second;
@@ -113,11 +197,91 @@ private:
         bool remove(long long int topicId, long long int elementId)
         {
             subscribers.erase(std::make_pair(topicId, elementId));
+            computeUpdateInterval();
+            computeCompositeUpdates();
             return subscribers.empty();
         }
 
+        void computeUpdateInterval()
+        {
+            //
+            // The samples are sent once to the listener for all its subscribers, the listener update interval is
+            // the smallest interval of its subscribers. A subscriber without maximum update rate disables the
+            // conflation.
+            //
+            updateInterval = std::chrono::microseconds::max();
+            for(const auto& s : subscribers)
+            {
+                updateInterval = std::min(updateInterval, s.second->updateInterval);
+            }
+            if(subscribers.empty())
+            {
+                updateInterval = std::chrono::microseconds::zero();
+            }
+        }
+
+        void computeCompositeUpdates()
+        {
+            // Composite partial updates are sent as full updates unless all the subscribers apply them
+            compositeUpdates = std::all_of(subscribers.begin(), subscribers.end(),
+                                           [](const auto& s) { return s.second->compositeUpdates; });
+        }
+
+        void removeConflation(const std::shared_ptr<Key>& key, Timer& timer)
+        {
+            // The conflation state of a key is discarded once the key is removed or no longer subscribed
+            for(const auto& s : subscribers)
+            {
+                if(s.second->keys.find(key) != s.second->keys.end())
+                {
+                    return;
+                }
+            }
+            auto p = conflations.find(key);
+            if(p != conflations.end())
+            {
+                if(p->second.timer)
+                {
+                    timer.cancel(p->second.timer);
+                }
+                conflations.erase(p);
+            }
+        }
+
         std::shared_ptr<DataStormContract::SessionPrx> proxy;
         std::map<std::pair<long long int, long long int>, std::shared_ptr<Subscriber>> subscribers;
+        std::chrono::microseconds updateInterval;
+        std::map<std::shared_ptr<Key>, Conflation> conflations;
+
+        // Whether or not all the subscribers apply composite partial updates (writers)
+        bool compositeUpdates;
+
+        // The credit granted by a reader with unread limits and the ids of the samples sent since (writers)
+        bool flowControl;
+        int credit;
+        std::deque<long long int> unacknowledged;
+
+        // The id of the last sample received from the listener (readers)
+        long long int lastId;
+
+        // The samples not yet written to the listener connection and its slow consumer state (writers)
+        std::shared_ptr<Backlog> backlog;
+        bool slow;
+        bool disconnecting;
+
+        // The keys with a dropped sample, the next partial update of these keys is sent as a full update (writers)
+        std::set<std::shared_ptr<Key>> droppedKeys;
+
+        // The batch oneway proxy used by writers which batch samples, the batch requests are queued by the proxy
+        std::shared_ptr<DataStormContract::SessionPrx> batchProxy;
+
+        // The twoway proxy used by writers with backlog limits to send samples through a node session forwarder
+        std::shared_ptr<DataStormContract::SessionPrx> twowayProxy;
+
+        // The session lane proxy and the listener proxy for this lane used by writers with a lane
+        bool laneChosen;
+        std::shared_ptr<DataStormContract::SessionPrx> lane;
+        std::shared_ptr<DataStormContract::SessionPrx> laneProxy;
     };
 
 public:
@@ -158,7 +322,8 @@ public:
                    const std::string&,
                    long long int,
                    const std::string&,
-                   int);
+                   int,
+                   const std::shared_ptr<DataStormContract::ElementConfig>&);
 
     void detachKey(long long int,
                    long long int,
@@ -177,7 +342,8 @@ public:
                       long long int,
                       const std::shared_ptr<Filter>&,
                       const std::string&,
-                      int);
+                      int,
+                      const std::shared_ptr<DataStormContract::ElementConfig>&);
 
     void detachFilter(long long int,
                       long long int,
@@ -203,6 +369,7 @@ public:
 
     virtual void queue(const std::shared_ptr<Sample>&, int, const std::shared_ptr<SessionI>&, const std::string&,
                        const std::chrono::time_point<std::chrono::system_clock>&, bool);
+    virtual void credit(const std::shared_ptr<SessionI>&, const std::string&, long long int, int);
 
     virtual std::string toString() const = 0;
     virtual std::shared_ptr<Ice::Communicator> getCommunicator() const override;
@@ -215,7 +382,12 @@ public:
     std::shared_ptr<DataStormContract::ElementConfig> getConfig() const;
 
     void waitForListeners(int count) const;
+    virtual void waitForListenersAsync(int, std::function<void(std::exception_ptr)>) override;
     bool hasListeners() const;
+    virtual void shutdown();
+
+    virtual DataStorm::ElementMetrics getMetrics() const;
+    virtual DataStorm::ElementDescription describe() const;
 
     TopicI* getTopic() const
     {
@@ -228,8 +400,12 @@ protected:
     virtual bool removeConnectedKey(const std::shared_ptr<Key>&, const std::shared_ptr<Subscriber>&);
 
     void notifyListenerWaiters(std::unique_lock<std::mutex>&) const;
+    bool matchListenerCount(int) const;
     void disconnect();
     virtual void destroyImpl() = 0;
+    virtual void completeWaiters(std::exception_ptr);
+
+    void incCounter(long long int SampleCounters::*, long long int = 1) const;
 
     const std::shared_ptr<TraceLevels> _traceLevels;
     const std::string _name;
@@ -238,19 +414,20 @@ protected:
     const std::shared_ptr<CallbackExecutor> _executor;
 
     size_t _listenerCount;
-    mutable std::shared_ptr<Sample> _sample;
+    mutable SampleCounters _counters;
     std::shared_ptr<DataStormContract::SessionPrx> _forwarder;
     std::map<std::shared_ptr<Key>, std::vector<std::shared_ptr<Subscriber>>> _connectedKeys;
     std::map<ListenerKey, Listener> _listeners;
+    bool _destroyed;
 
 private:
 
-    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const;
+    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const override;
 
     const std::shared_ptr<TopicI> _parent;
     mutable size_t _waiters;
     mutable size_t _notified;
-    bool _destroyed;
+    mutable std::vector<std::pair<int, std::function<void(std::exception_ptr)>>> _asyncWaiters;
 
     std::function<void(DataStorm::CallbackReason, std::shared_ptr<Key>)> _onConnectedKeys;
     std::function<void(DataStorm::CallbackReason, std::string)> _onConnectedElements;
@@ -269,6 +446,10 @@ public:
     virtual void waitForUnread(unsigned int) const override;
     virtual bool hasUnread() const override;
     virtual std::shared_ptr<Sample> getNextUnread() override;
+    virtual void waitForUnreadAsync(unsigned int, std::function<void(std::exception_ptr)>) override;
+    virtual void getNextUnreadAsync(std::function<void(std::shared_ptr<Sample>, std::exception_ptr)>) override;
+    virtual std::vector<std::shared_ptr<Sample>> getUnread(unsigned int) override;
+    virtual DataStorm::NotificationHandle getNotificationHandle() override;
 
     virtual void initSamples(const std::vector<std::shared_ptr<Sample>>&, long long int, long long int, int,
                              const std::chrono::time_point<std::chrono::system_clock>&, bool) override;
@@ -278,19 +459,48 @@ public:
     virtual void onSamples(std::function<void(const std::vector<std::shared_ptr<Sample>>&)>,
                            std::function<void(const std::shared_ptr<Sample>&)>) override;
 
+    virtual DataStorm::LatencyStatistics getLatencyStatistics() const override;
+    virtual void resetLatencyStatistics() override;
+
+    virtual DataStorm::ElementMetrics getMetrics() const override;
+    virtual DataStorm::ElementDescription describe() const override;
+
 protected:
 
     virtual bool matchKey(const std::shared_ptr<Key>&) const = 0;
     virtual bool addConnectedKey(const std::shared_ptr<Key>&, const std::shared_ptr<Subscriber>&) override;
+    virtual void completeWaiters(std::exception_ptr) override;
+
+    virtual long long int getElementId() const = 0;
+
+    void notifyUnreadWaiters();
+    void updateNotifier();
+    bool replaceUnread(const std::shared_ptr<Sample>&);
+    void pushUnread(const std::shared_ptr<Sample>&);
+    void rebuildKeySlots();
+    size_t getUnreadLimit() const;
+    void trimUnread();
+    void grantCredit();
 
     TopicReaderI* _parent;
 
     std::deque<std::shared_ptr<Sample>> _samples;
+    size_t _pushedCount;
+    std::unordered_map<std::shared_ptr<Key>, size_t> _keySlots;
     std::shared_ptr<Sample> _last;
     int _instanceCount;
     DataStorm::DiscardPolicy _discardPolicy;
     std::chrono::time_point<std::chrono::system_clock> _lastSendTime;
     std::function<void(const std::shared_ptr<Sample>&)> _onSamples;
+    std::vector<std::pair<unsigned int, std::function<void(std::exception_ptr)>>> _unreadWaiters;
+    std::deque<std::function<void(std::shared_ptr<Sample>, std::exception_ptr)>> _nextUnreadWaiters;
+    std::unique_ptr<Notifier> _notifier;
+    bool _notifierSignaled;
+    const bool _latencyStatistics;
+    LatencyHistogram _latency;
+    size_t _averageSampleSize;
+    size_t _credit;
+    size_t _receivedSinceCredit;
 };
 
 class DataWriterI : public DataElementI, public DataWriter
@@ -298,18 +508,108 @@ class DataWriterI : public DataElementI, public DataWriter
 public:
 
     DataWriterI(TopicWriterI*, const std::string&, long long int, const DataStorm::WriterConfig&);
-    void init();
+
+    virtual void destroy() override;
 
     virtual void publish(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&) override;
+    virtual void flush(std::function<void()>) override;
+
+    bool publishQueued(size_t);
+    void discardQueued();
+
+    virtual void credit(const std::shared_ptr<SessionI>&, const std::string&, long long int, int) override;
+
+    virtual DataStorm::ElementMetrics getMetrics() const override;
+    virtual DataStorm::ElementDescription describe() const override;
 
 protected:
 
-    virtual void send(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&) const = 0;
+    struct Target
+    {
+        std::shared_ptr<SessionI> session;
+        std::shared_ptr<DataStormContract::SessionPrx> proxy;
+        std::shared_ptr<Backlog> backlog;
+        bool fullUpdate; // Send the partial update as a full update, the target missed a previous sample
+    };
+
+    virtual DataStormContract::DataSample encode(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&) const = 0;
+    virtual std::vector<Target> getTargets(const std::shared_ptr<Sample>&) = 0;
+    virtual bool hasCredit(const std::shared_ptr<Sample>&) const = 0;
+    virtual void send(const DataStormContract::DataSample&, const std::vector<Target>&) const = 0;
+
+    void publishSample(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&);
+    void publishFailed(const PublishQueue::Item&, const std::string&);
+    bool checkSlowConsumer(const ListenerKey&, Listener&);
+    std::shared_ptr<DataStormContract::SessionPrx> getSendProxy(const ListenerKey&, Listener&) const;
+    void queueBatch(const std::vector<Target>&, size_t);
+    void flushBatch();
+    void flushBatchImpl();
+    void addToHistory(const std::shared_ptr<Sample>&);
+    void scheduleExpiry();
+    void cancelExpiry();
 
     TopicWriterI* _parent;
-    std::shared_ptr<DataStormContract::SubscriberSessionPrx> _subscribers;
+    const bool _async;
+    const DataStorm::FlowControlPolicy _flowControlPolicy;
+    const long long int _maxBacklogSamples;
+    const long long int _maxBacklogBytes;
+    const DataStorm::SlowConsumerPolicy _slowConsumerPolicy;
+    const bool _batch;
+    const size_t _batchSize;
+    const std::chrono::milliseconds _batchFlushInterval;
+    const int _lane;
+    PublishQueue _queue;
+    std::mutex _publishMutex;
+
+    //
+    // The send mutex serializes the sends of the published and conflated samples, it's locked with the topic mutex
+    // locked and released once the sample is sent so that the samples are sent in the order of their ids.
+    //
+    std::mutex _sendMutex;
+
     std::deque<std::shared_ptr<Sample>> _samples;
     std::shared_ptr<Sample> _last;
+    Timer::TimerId _expiryTimer;
+
+    //
+    // The history samples sent to the last attached reader. They are sent to the next attached readers with the
+    // same configuration until the history changes, the history isn't encoded again for each reader.
+    //
+    struct HistoryChunk
+    {
+        HistoryChunk() : valid(false), sampleCount(0), clearHistory(-1), compositeUpdates(false), lastId(0)
+        {
+        }
+
+        bool valid;
+        std::shared_ptr<Key> key;
+        std::shared_ptr<Filter> sampleFilter;
+        int sampleCount;
+        int clearHistory;
+        bool compositeUpdates;
+        long long int lastId;
+        DataStormContract::DataSamples samples;
+    };
+    HistoryChunk _historyChunk;
+
+    //
+    // The proxies with batched samples. The batch state is protected by the batch mutex rather than the publish
+    // mutex, it's also locked by the timer thread to flush the batch. It can be locked with the topic mutex locked.
+    //
+    struct BatchProxy
+    {
+        std::shared_ptr<DataStormContract::SessionPrx> proxy;
+
+        // The batched samples accounted for in the listener backlog until the batch is written to the connection
+        std::shared_ptr<Backlog> backlog;
+        long long int samples;
+        long long int bytes;
+    };
+
+    std::mutex _batchMutex;
+    std::vector<BatchProxy> _batchProxies;
+    size_t _batchBytes;
+    Timer::TimerId _batchTimer;
 };
 
 class KeyDataReaderI : public DataReaderI
@@ -329,6 +629,7 @@ public:
 private:
 
     virtual bool matchKey(const std::shared_ptr<Key>&) const override;
+    virtual long long int getElementId() const override;
 
     const std::vector<std::shared_ptr<Key>> _keys;
 };
@@ -357,8 +658,15 @@ public:
 
 private:
 
-    virtual void send(const std::shared_ptr<Key>&, const std::shared_ptr<Sample>&) const override;
-    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const override;
+    virtual DataStormContract::DataSample encode(const std::shared_ptr<Key>&,
+                                                 const std::shared_ptr<Sample>&) const override;
+    virtual std::vector<Target> getTargets(const std::shared_ptr<Sample>&) override;
+    virtual bool hasCredit(const std::shared_ptr<Sample>&) const override;
+    virtual void send(const DataStormContract::DataSample&, const std::vector<Target>&) const override;
+
+    bool conflate(const ListenerKey&, Listener&, const std::shared_ptr<Sample>&);
+    void scheduleConflated(const ListenerKey&, Conflation&, const std::shared_ptr<Key>&, std::chrono::milliseconds);
+    void sendConflated(const ListenerKey&, const std::shared_ptr<Key>&);
 
     const std::vector<std::shared_ptr<Key>> _keys;
 };
@@ -380,6 +688,7 @@ public:
 private:
 
     virtual bool matchKey(const std::shared_ptr<Key>&) const override;
+    virtual long long int getElementId() const override;
 
     const std::shared_ptr<Filter> _filter;
 };
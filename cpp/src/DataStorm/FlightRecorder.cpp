@@ -0,0 +1,318 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/FlightRecorder.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#   include <fcntl.h>
+#   include <signal.h>
+#   include <unistd.h>
+#endif
+
+using namespace std;
+using namespace DataStormI;
+
+namespace
+{
+
+const size_t maxThreads = 1024;
+
+struct Buffer
+{
+    Buffer(uint32_t threadId) :
+        head(0),
+        used(true),
+        thread(threadId)
+    {
+        for(auto& sequence : sequences)
+        {
+            sequence.store(0, memory_order_relaxed);
+        }
+    }
+
+    atomic<uint64_t> head;
+    atomic<bool> used;
+    atomic<uint32_t> thread;
+    FlightRecord records[FlightRecorder::capacity];
+
+    //
+    // The sequence of each record is the position of the record in the buffer plus one once the record is
+    // committed, it's reset to zero while the record is written. A record copied by a dump is consistent if its
+    // sequence is the expected one before and after the copy.
+    //
+    atomic<uint64_t> sequences[FlightRecorder::capacity];
+};
+
+//
+// The buffers are never released: the buffer of a thread which exited is kept for dumps and reused by the next
+// thread which records an event. The registry is lock-free so that it can be dumped from a signal handler.
+//
+atomic<Buffer*> buffers[maxThreads];
+atomic<uint32_t> nextThread(0);
+
+Buffer*
+acquireBuffer()
+{
+    auto thread = ++nextThread;
+    for(auto& slot : buffers)
+    {
+        auto buffer = slot.load(memory_order_acquire);
+        if(!buffer)
+        {
+            break;
+        }
+        bool used = false;
+        if(buffer->used.compare_exchange_strong(used, true))
+        {
+            buffer->thread.store(thread, memory_order_relaxed);
+            return buffer;
+        }
+    }
+
+    unique_ptr<Buffer> buffer(new Buffer(thread));
+    for(auto& slot : buffers)
+    {
+        Buffer* expected = nullptr;
+        if(slot.compare_exchange_strong(expected, buffer.get()))
+        {
+            return buffer.release();
+        }
+    }
+    return nullptr; // Too many threads, the events of this thread aren't recorded.
+}
+
+class ThreadBuffer
+{
+public:
+
+    ThreadBuffer() :
+        buffer(acquireBuffer())
+    {
+    }
+
+    ~ThreadBuffer()
+    {
+        if(buffer)
+        {
+            buffer->used.store(false, memory_order_release);
+        }
+    }
+
+    Buffer* const buffer;
+};
+
+//
+// Copy the committed records of the buffer from the oldest to the newest, the records being written or
+// overwritten while being copied are skipped. Only async-signal-safe calls are used, it's also called by the crash
+// handler.
+//
+size_t
+copyRecords(const Buffer& buffer, FlightRecord* records)
+{
+    auto head = buffer.head.load(memory_order_acquire);
+    auto count = min(head, FlightRecorder::capacity);
+    size_t copied = 0;
+    for(auto i = head - count; i < head; ++i)
+    {
+        const auto& sequence = buffer.sequences[i & (FlightRecorder::capacity - 1)];
+        if(sequence.load(memory_order_acquire) != i + 1)
+        {
+            continue;
+        }
+        records[copied] = buffer.records[i & (FlightRecorder::capacity - 1)];
+        atomic_thread_fence(memory_order_acquire);
+        if(sequence.load(memory_order_relaxed) == i + 1)
+        {
+            ++copied;
+        }
+    }
+    return copied;
+}
+
+FlightRecordHeader
+makeHeader(uint32_t threadCount)
+{
+    FlightRecordHeader header;
+    memcpy(header.magic, flightRecordMagic, sizeof(header.magic));
+    header.version = flightRecordVersion;
+    header.recordSize = sizeof(FlightRecord);
+    header.threadCount = threadCount;
+    return header;
+}
+
+#ifndef _WIN32
+
+char crashFile[1024];
+FlightRecord crashRecords[FlightRecorder::capacity];
+const int crashSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+struct sigaction previousActions[sizeof(crashSignals) / sizeof(crashSignals[0])];
+
+bool
+writeFd(int fd, const void* data, size_t size)
+{
+    auto p = static_cast<const char*>(data);
+    while(size > 0)
+    {
+        auto written = ::write(fd, p, size);
+        if(written <= 0)
+        {
+            return false;
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+//
+// Only async-signal-safe calls are used to write the dump. The records of each thread are copied to a static
+// buffer before being written, the records being written by other threads are skipped.
+//
+extern "C" void
+crashHandler(int signal)
+{
+    int fd = ::open(crashFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd >= 0)
+    {
+        uint32_t threadCount = 0;
+        for(const auto& slot : buffers)
+        {
+            auto buffer = slot.load(memory_order_acquire);
+            if(buffer && buffer->head.load(memory_order_acquire) > 0)
+            {
+                ++threadCount;
+            }
+        }
+
+        auto header = makeHeader(threadCount);
+        bool ok = writeFd(fd, &header, sizeof(header));
+        for(const auto& slot : buffers)
+        {
+            auto buffer = slot.load(memory_order_acquire);
+            auto head = buffer ? buffer->head.load(memory_order_acquire) : 0;
+            if(!ok || head == 0)
+            {
+                continue;
+            }
+
+            auto count = copyRecords(*buffer, crashRecords);
+            FlightRecordThread thread = { buffer->thread.load(memory_order_relaxed), static_cast<uint32_t>(count) };
+            ok = writeFd(fd, &thread, sizeof(thread));
+            ok = ok && writeFd(fd, crashRecords, count * sizeof(FlightRecord));
+        }
+        ::close(fd);
+    }
+
+    //
+    // Restore the previous handler and raise the signal again.
+    //
+    for(size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i)
+    {
+        if(crashSignals[i] == signal)
+        {
+            sigaction(signal, &previousActions[i], nullptr);
+        }
+    }
+    raise(signal);
+}
+
+#endif
+
+}
+
+const uint64_t FlightRecorder::capacity;
+
+void
+FlightRecorder::record(FlightEvent event, long long int topic, long long int element, long long int sample)
+{
+    static thread_local ThreadBuffer threadBuffer;
+
+    auto buffer = threadBuffer.buffer;
+    if(!buffer)
+    {
+        return;
+    }
+
+    //
+    // Each buffer has a single writer. The record sequence is reset while the record is written and set once it's
+    // committed, the head is published after the record is committed.
+    //
+    auto head = buffer->head.load(memory_order_relaxed);
+    auto& sequence = buffer->sequences[head & (capacity - 1)];
+    sequence.store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    auto& record = buffer->records[head & (capacity - 1)];
+    record.timestamp = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    record.topic = topic;
+    record.element = element;
+    record.sample = sample;
+    record.event = static_cast<uint32_t>(event);
+    record.thread = buffer->thread.load(memory_order_relaxed);
+    sequence.store(head + 1, memory_order_release);
+    buffer->head.store(head + 1, memory_order_release);
+}
+
+void
+FlightRecorder::dump(ostream& os)
+{
+    vector<pair<uint32_t, vector<FlightRecord>>> threads;
+    for(const auto& slot : buffers)
+    {
+        auto buffer = slot.load(memory_order_acquire);
+        if(!buffer)
+        {
+            continue;
+        }
+
+        vector<FlightRecord> records(capacity);
+        records.resize(copyRecords(*buffer, records.data()));
+        if(!records.empty())
+        {
+            threads.emplace_back(buffer->thread.load(memory_order_relaxed), move(records));
+        }
+    }
+
+    auto header = makeHeader(static_cast<uint32_t>(threads.size()));
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(const auto& p : threads)
+    {
+        FlightRecordThread thread = { p.first, static_cast<uint32_t>(p.second.size()) };
+        os.write(reinterpret_cast<const char*>(&thread), sizeof(thread));
+        os.write(reinterpret_cast<const char*>(p.second.data()),
+                 static_cast<streamsize>(p.second.size() * sizeof(FlightRecord)));
+    }
+}
+
+void
+FlightRecorder::dumpOnCrash(const string& file)
+{
+#ifndef _WIN32
+    //
+    // The handlers are installed once for the process, the file of the first node wins.
+    //
+    static once_flag installed;
+    call_once(installed, [&file]
+    {
+        strncpy(crashFile, file.c_str(), sizeof(crashFile) - 1);
+        for(size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i)
+        {
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_handler = crashHandler;
+            sigemptyset(&action.sa_mask);
+            sigaction(crashSignals[i], &action, &previousActions[i]);
+        }
+    });
+#else
+    (void)file;
+#endif
+}
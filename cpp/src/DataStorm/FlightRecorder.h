@@ -0,0 +1,106 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace DataStormI
+{
+
+//
+// The flight recorder records the data path events of all the nodes of the process in per-thread ring buffers
+// of fixed size binary records. Recording an event doesn't lock or allocate: it writes a record in the buffer of
+// the calling thread. The recording can be dumped with the node admin facet or to the file set with the
+// DataStorm.Node.FlightRecorder.File property when the node is destroyed. The signal handlers which dump the
+// recording to this file when the process crashes are only installed if DataStorm.Node.FlightRecorder.DumpOnCrash
+// is also set. The dump is decoded with the dsrecorder tool.
+//
+// The dump format is a FlightRecordHeader followed, for each thread, by a FlightRecordThread header and the
+// thread records from the oldest to the newest. Integers are encoded in the byte order of the recording host,
+// the decoder uses the header version to detect it.
+//
+enum class FlightEvent : std::uint32_t
+{
+    Published = 1,      // A writer published a sample.
+    Sent,               // A writer sent a sample to a session.
+    Received,           // A session received a sample for a remote element.
+    Queued,             // A reader queued a sample.
+    Initialized,        // A reader queued a sample from the history sent on connection.
+    Filtered,           // A reader skipped a sample not matching its facet or keys.
+    Discarded,          // A reader discarded a sample because of its discard policy.
+};
+
+inline const char*
+toString(FlightEvent event)
+{
+    switch(event)
+    {
+    case FlightEvent::Published:
+        return "published";
+    case FlightEvent::Sent:
+        return "sent";
+    case FlightEvent::Received:
+        return "received";
+    case FlightEvent::Queued:
+        return "queued";
+    case FlightEvent::Initialized:
+        return "initialized";
+    case FlightEvent::Filtered:
+        return "filtered";
+    case FlightEvent::Discarded:
+        return "discarded";
+    }
+    return "unknown";
+}
+
+struct FlightRecord
+{
+    std::int64_t timestamp; // Nanoseconds since the epoch.
+    std::int64_t topic;
+    std::int64_t element;
+    std::int64_t sample;
+    std::uint32_t event;
+    std::uint32_t thread;
+};
+static_assert(sizeof(FlightRecord) == 40, "unexpected FlightRecord size");
+
+struct FlightRecordHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t threadCount;
+};
+
+struct FlightRecordThread
+{
+    std::uint32_t thread;
+    std::uint32_t count;
+};
+
+const char flightRecordMagic[4] = { 'D', 'S', 'F', 'R' };
+const std::uint32_t flightRecordVersion = 1;
+
+class FlightRecorder
+{
+public:
+
+    //
+    // The number of records of each thread buffer, must be a power of 2.
+    //
+    static const std::uint64_t capacity = 4096;
+
+    static void record(FlightEvent, long long int, long long int, long long int);
+    static void dump(std::ostream&);
+
+    //
+    // Dump the recording to the given file if the process receives a fatal signal. The file is written with
+    // async-signal-safe calls only. This is a no-op on Windows.
+    //
+    static void dumpOnCrash(const std::string&);
+};
+
+}
@@ -3,24 +3,111 @@
 //
 #include <DataStorm/ForwarderManager.h>
 
+#include <thread>
+
 using namespace std;
 using namespace DataStormI;
 
+namespace
+{
+
+bool
+parseId(const string& name, uint64_t& id)
+{
+    if(name.empty() || name.size() > 20)
+    {
+        return false;
+    }
+    id = 0;
+    for(auto c : name)
+    {
+        if(c < '0' || c > '9')
+        {
+            return false;
+        }
+        auto next = id * 10 + static_cast<uint64_t>(c - '0');
+        if(next < id)
+        {
+            return false;
+        }
+        id = next;
+    }
+    return true;
+}
+
+}
+
+const uint32_t ForwarderManager::slotBits;
+const uint32_t ForwarderManager::slotCount;
+const uint32_t ForwarderManager::maxChunks;
+
 ForwarderManager::ForwarderManager(const shared_ptr<Ice::ObjectAdapter>& adapter, const string& category) :
-    _adapter(adapter), _category(category), _nextId(0)
+    _adapter(adapter), _category(category), _epoch(0)
+{
+    for(auto& chunk : _chunks)
+    {
+        chunk.store(nullptr, memory_order_relaxed);
+    }
+    _readers[0].store(0, memory_order_relaxed);
+    _readers[1].store(0, memory_order_relaxed);
+}
+
+ForwarderManager::~ForwarderManager()
 {
+    for(auto& c : _chunks)
+    {
+        auto chunk = c.load();
+        if(chunk)
+        {
+            for(auto& entry : chunk->entries)
+            {
+                delete entry.load();
+            }
+            delete chunk;
+        }
+    }
 }
 
 shared_ptr<Ice::ObjectPrx>
-ForwarderManager::add(function<void(Ice::ByteSeq, Response, Exception, const Ice::Current&)> forwarder)
+ForwarderManager::add(shared_ptr<Forwarder> forwarder)
 {
-    lock_guard<mutex> lock(_mutex);
-    ostringstream os;
-    os << _nextId++;
-    _forwarders.emplace(os.str(), move(forwarder));
+    uint64_t id;
+    {
+        lock_guard<mutex> lock(_mutex);
+        uint32_t slot;
+        if(!_free.empty())
+        {
+            slot = _free.back();
+            _free.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(_generations.size());
+            if(slot >> slotBits >= maxChunks)
+            {
+                throw Ice::MemoryLimitException(__FILE__, __LINE__, "too many forwarders");
+            }
+            if((slot & (slotCount - 1)) == 0)
+            {
+                auto chunk = new Chunk;
+                for(auto& entry : chunk->entries)
+                {
+                    entry.store(nullptr, memory_order_relaxed);
+                }
+                _chunks[slot >> slotBits].store(chunk);
+            }
+            _generations.push_back(0);
+        }
+
+        auto generation = _generations[slot];
+        auto& entry = _chunks[slot >> slotBits].load()->entries[slot & (slotCount - 1)];
+        entry.store(new Entry { generation, move(forwarder) });
+        id = (static_cast<uint64_t>(generation) << 32) | slot;
+    }
+
     try
     {
-        return _adapter->createProxy({ os.str(), _category});
+        return _adapter->createProxy({ to_string(id), _category });
     }
     catch(const Ice::ObjectAdapterDeactivatedException&)
     {
@@ -28,35 +115,68 @@ ForwarderManager::add(function<void(Ice::ByteSeq, Response, Exception, const Ice
     }
 }
 
-shared_ptr<Ice::ObjectPrx>
-ForwarderManager::add(function<void(Ice::ByteSeq, const Ice::Current&)> forwarder)
+void
+ForwarderManager::remove(const Ice::Identity& identity)
 {
-    return add([forwarder=move(forwarder)](auto inEncaps, auto response, auto exception, auto current)
+    uint64_t id;
+    if(!parseId(identity.name, id))
     {
-        try
+        return;
+    }
+
+    vector<const Entry*> removed;
+    {
+        lock_guard<mutex> lock(_mutex);
+        auto slot = static_cast<uint32_t>(id);
+        if(slot >= _generations.size() || _generations[slot] != static_cast<uint32_t>(id >> 32))
         {
-            forwarder(inEncaps, current);
-            response(true, Ice::ByteSeq());
+            return;
         }
-        catch(...)
+
+        auto entry = _chunks[slot >> slotBits].load()->entries[slot & (slotCount - 1)].exchange(nullptr);
+        if(!entry)
         {
-            exception(current_exception());
+            return;
         }
-    });
-}
+        ++_generations[slot];
+        _free.push_back(slot);
+        removed.push_back(entry);
+        synchronize();
+    }
 
-void
-ForwarderManager::remove(const Ice::Identity& id)
-{
-    lock_guard<mutex> lock(_mutex);
-    _forwarders.erase(id.name);
+    // The forwarders are released once the mutex is unlocked, they might hold the last reference of their owner.
+    for(auto entry : removed)
+    {
+        delete entry;
+    }
 }
 
 void
 ForwarderManager::destroy()
 {
-    lock_guard<mutex> lock(_mutex);
-    _forwarders.clear();
+    vector<const Entry*> removed;
+    {
+        lock_guard<mutex> lock(_mutex);
+        for(uint32_t slot = 0; slot < _generations.size(); ++slot)
+        {
+            auto entry = _chunks[slot >> slotBits].load()->entries[slot & (slotCount - 1)].exchange(nullptr);
+            if(entry)
+            {
+                ++_generations[slot];
+                _free.push_back(slot);
+                removed.push_back(entry);
+            }
+        }
+        if(!removed.empty())
+        {
+            synchronize();
+        }
+    }
+
+    for(auto entry : removed)
+    {
+        delete entry;
+    }
 }
 
 void
@@ -65,15 +185,79 @@ ForwarderManager::ice_invokeAsync(Ice::ByteSeq inEncaps,
                                   function<void(exception_ptr)> exception,
                                   const Ice::Current& current)
 {
-    std::function<void(Ice::ByteSeq, Response, Exception, const Ice::Current&)> forwarder;
+    uint64_t id;
+    shared_ptr<Forwarder> forwarder;
+    if(parseId(current.id.name, id))
     {
-        lock_guard<mutex> lock(_mutex);
-        auto p = _forwarders.find(current.id.name);
-        if(p == _forwarders.end())
+        forwarder = get(id);
+    }
+    if(!forwarder)
+    {
+        throw Ice::ObjectNotExistException(__FILE__, __LINE__, current.id, current.facet, current.operation);
+    }
+
+    try
+    {
+        forwarder->forward(inEncaps, current);
+        response(true, Ice::ByteSeq());
+    }
+    catch(...)
+    {
+        exception(current_exception());
+    }
+}
+
+shared_ptr<Forwarder>
+ForwarderManager::get(uint64_t id) const
+{
+    auto slot = static_cast<uint32_t>(id);
+    if(slot >> slotBits >= maxChunks)
+    {
+        return nullptr;
+    }
+
+    //
+    // Register as a reader of the current epoch. If the epoch changed while registering, the writer might have
+    // missed the registration so we retry with the new epoch.
+    //
+    uint64_t epoch;
+    while(true)
+    {
+        epoch = _epoch.load();
+        ++_readers[epoch & 1];
+        if(_epoch.load() == epoch)
+        {
+            break;
+        }
+        --_readers[epoch & 1];
+    }
+
+    shared_ptr<Forwarder> forwarder;
+    auto chunk = _chunks[slot >> slotBits].load();
+    if(chunk)
+    {
+        auto entry = chunk->entries[slot & (slotCount - 1)].load();
+        if(entry && entry->generation == static_cast<uint32_t>(id >> 32))
         {
-            throw Ice::ObjectNotExistException(__FILE__, __LINE__, current.id, current.facet, current.operation);
+            forwarder = entry->forwarder;
         }
-        forwarder = p->second;
     }
-    forwarder(move(inEncaps), move(response), move(exception), current);
+
+    --_readers[epoch & 1];
+    return forwarder;
+}
+
+void
+ForwarderManager::synchronize()
+{
+    // Called with _mutex locked
+    //
+    // Start a new epoch and wait for the readers of the previous epoch, they are the only readers which might
+    // still access the removed entries. Readers only hold the epoch to copy the forwarder so the wait is short.
+    //
+    auto epoch = _epoch.fetch_add(1);
+    while(_readers[epoch & 1].load() > 0)
+    {
+        this_thread::yield();
+    }
 }
@@ -7,39 +7,82 @@
 
 #include <Ice/Ice.h>
 
+#include <atomic>
+
 namespace DataStormI
 {
 
 class Instance;
 
-class ForwarderManager : public Ice::BlobjectAsync
+//
+// A forwarder receives the invocations made on its collocated proxy and forwards them to the proxies of its
+// listeners.
+//
+class Forwarder
 {
 public:
 
-    using Response = std::function<void(bool, const std::vector<Ice::Byte>&)>;
-    using Exception = std::function<void(std::exception_ptr)>;
+    virtual ~Forwarder() = default;
+
+    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const = 0;
+};
+
+//
+// The forwarder manager dispatches the invocations on the collocated forwarder proxies. The forwarders are
+// registered in slots indexed by an integer id, the identity name of a forwarder proxy is the decimal form of
+// its id. The id includes the slot generation so that the proxy of a removed forwarder never reaches the next
+// forwarder registered in the same slot.
+//
+// Dispatching an invocation doesn't lock: the slots are read within an epoch and a removed forwarder is only
+// released once the readers of the epoch in which it was removed are done.
+//
+class ForwarderManager : public Ice::BlobjectAsync
+{
+public:
 
     ForwarderManager(const std::shared_ptr<Ice::ObjectAdapter>&, const std::string&);
+    virtual ~ForwarderManager();
 
-    std::shared_ptr<Ice::ObjectPrx> add(std::function<void(Ice::ByteSeq, Response, Exception, const Ice::Current&)>);
-    std::shared_ptr<Ice::ObjectPrx> add(std::function<void(Ice::ByteSeq, const Ice::Current&)>);
+    std::shared_ptr<Ice::ObjectPrx> add(std::shared_ptr<Forwarder>);
     void remove(const Ice::Identity&);
 
     void destroy();
 
 private:
 
+    static const std::uint32_t slotBits = 8;
+    static const std::uint32_t slotCount = 1 << slotBits;
+    static const std::uint32_t maxChunks = 4096;
+
+    struct Entry
+    {
+        const std::uint32_t generation;
+        const std::shared_ptr<Forwarder> forwarder;
+    };
+
+    struct Chunk
+    {
+        std::atomic<const Entry*> entries[slotCount];
+    };
+
     virtual void ice_invokeAsync(Ice::ByteSeq,
                                  std::function<void(bool, const std::vector<Ice::Byte>&)>,
                                  std::function<void(std::exception_ptr)>,
                                  const Ice::Current&);
 
+    std::shared_ptr<Forwarder> get(std::uint64_t) const;
+    void synchronize();
+
     const std::shared_ptr<Ice::ObjectAdapter> _adapter;
     const std::string _category;
 
     std::mutex _mutex;
-    std::map<std::string, std::function<void(Ice::ByteSeq, Response, Exception, const Ice::Current&)>> _forwarders;
-    unsigned int _nextId;
+    std::vector<std::uint32_t> _generations;
+    std::vector<std::uint32_t> _free;
+
+    std::atomic<Chunk*> _chunks[maxChunks];
+    std::atomic<std::uint64_t> _epoch;
+    mutable std::atomic<int> _readers[2];
 };
 
 }
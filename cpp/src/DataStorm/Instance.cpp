@@ -11,13 +11,23 @@
 #include <DataStorm/Node.h>
 #include <DataStorm/CallbackExecutor.h>
 #include <DataStorm/Timer.h>
+#include <DataStorm/PublishExecutor.h>
+#include <DataStorm/MetricsI.h>
+#include <DataStorm/AdminI.h>
+#include <DataStorm/FlightRecorder.h>
 
 #include <IceUtil/UUID.h>
 
+#include <fstream>
+
 using namespace std;
 using namespace DataStormI;
 
-Instance::Instance(const shared_ptr<Ice::Communicator>& communicator) : _communicator(communicator), _shutdown(false)
+Instance::Instance(const shared_ptr<Ice::Communicator>& communicator) :
+    _communicator(communicator),
+    _metricsFacet(false),
+    _adminFacet(false),
+    _shutdown(false)
 {
     shared_ptr<Ice::Properties> properties = _communicator->getProperties();
 
@@ -89,6 +99,7 @@ Instance::Instance(const shared_ptr<Ice::Communicator>& communicator) : _communi
     _retryDelay = chrono::milliseconds(properties->getPropertyAsIntWithDefault("DataStorm.Node.RetryDelay", 500));
     _retryMultiplier = properties->getPropertyAsIntWithDefault("DataStorm.Node.RetryMultiplier", 2);
     _retryCount = properties->getPropertyAsIntWithDefault("DataStorm.Node.RetryCount", 6);
+    _compositeUpdates = properties->getPropertyAsIntWithDefault("DataStorm.Node.CompositeUpdates", 1) > 0;
 
     //
     // Create a collocated object adapter with a random name to prevent user configuration
@@ -104,6 +115,8 @@ Instance::Instance(const shared_ptr<Ice::Communicator>& communicator) : _communi
     _executor = make_shared<CallbackExecutor>();
     _connectionManager = make_shared<ConnectionManager>(_executor);
     _timer = make_shared<Timer>();
+    _publishExecutor =
+        make_shared<PublishExecutor>(properties->getPropertyAsIntWithDefault("DataStorm.Node.Sender.ThreadCount", 1));
     _traceLevels = make_shared<TraceLevels>(_communicator);
 }
 
@@ -120,6 +133,47 @@ Instance::init()
     _nodeSessionManager = make_shared<NodeSessionManager>(self, _node);
     _nodeSessionManager->init();
 
+    //
+    // Provide the node metrics with the DataStorm.Metrics facet of the Ice admin object if enabled. The facet is
+    // only registered by the first node if several nodes share the same communicator.
+    //
+    _metricsAdmin = make_shared<MetricsAdminI>(_topicFactory, _node, _executor);
+    if(_communicator->getProperties()->getPropertyAsIntWithDefault("DataStorm.Node.Metrics.Enabled", 0) > 0)
+    {
+        try
+        {
+            _communicator->addAdminFacet(_metricsAdmin, "DataStorm.Metrics");
+            _metricsFacet = true;
+        }
+        catch(const Ice::AlreadyRegisteredException&)
+        {
+        }
+    }
+
+    if(_communicator->getProperties()->getPropertyAsIntWithDefault("DataStorm.Node.Admin.Enabled", 0) > 0)
+    {
+        try
+        {
+            _communicator->addAdminFacet(make_shared<NodeAdminI>(_topicFactory, _node, _executor, _timer),
+                                         "DataStorm.Admin");
+            _adminFacet = true;
+        }
+        catch(const Ice::AlreadyRegisteredException&)
+        {
+        }
+    }
+
+    //
+    // Dump the flight recording to the given file if the process crashes. Installing the signal handlers is
+    // opt-in, they replace the application handlers for the process.
+    //
+    _flightRecorderFile = _communicator->getProperties()->getProperty("DataStorm.Node.FlightRecorder.File");
+    if(!_flightRecorderFile.empty() &&
+       _communicator->getProperties()->getPropertyAsIntWithDefault("DataStorm.Node.FlightRecorder.DumpOnCrash", 0) > 0)
+    {
+        FlightRecorder::dumpOnCrash(_flightRecorderFile);
+    }
+
     auto lookupI = make_shared<LookupI>(_nodeSessionManager, _topicFactory, _node->getProxy());
     _adapter->add(lookupI, {"Lookup", "DataStorm"});
     if(_multicastAdapter)
@@ -172,6 +226,7 @@ Instance::waitForShutdown() const
 void
 Instance::destroy(bool ownsCommunicator)
 {
+    _publishExecutor->destroy();
     _timer->destroy();
 
     if(ownsCommunicator)
@@ -180,6 +235,14 @@ Instance::destroy(bool ownsCommunicator)
     }
     else
     {
+        if(_metricsFacet)
+        {
+            _communicator->removeAdminFacet("DataStorm.Metrics");
+        }
+        if(_adminFacet)
+        {
+            _communicator->removeAdminFacet("DataStorm.Admin");
+        }
         _adapter->destroy();
         _collocatedAdapter->destroy();
         if(_multicastAdapter)
@@ -192,4 +255,10 @@ Instance::destroy(bool ownsCommunicator)
     _executor->destroy();
     _connectionManager->destroy();
     _collocatedForwarder->destroy();
+
+    if(!_flightRecorderFile.empty())
+    {
+        ofstream os(_flightRecorderFile, ios::binary);
+        FlightRecorder::dump(os);
+    }
 }
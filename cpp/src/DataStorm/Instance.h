@@ -29,6 +29,8 @@ class ForwarderManager;
 class NodeI;
 class CallbackExecutor;
 class Timer;
+class PublishExecutor;
+class MetricsAdminI;
 
 class Instance : public std::enable_shared_from_this<Instance>
 {
@@ -114,6 +116,20 @@ public:
         return _timer;
     }
 
+    std::shared_ptr<PublishExecutor>
+    getPublishExecutor() const
+    {
+        assert(_publishExecutor);
+        return _publishExecutor;
+    }
+
+    std::shared_ptr<MetricsAdminI>
+    getMetricsAdmin() const
+    {
+        assert(_metricsAdmin);
+        return _metricsAdmin;
+    }
+
     std::chrono::milliseconds
     getRetryDelay(int count) const
     {
@@ -126,6 +142,12 @@ public:
         return _retryCount;
     }
 
+    bool
+    getCompositeUpdates() const
+    {
+        return _compositeUpdates;
+    }
+
     void shutdown();
     bool isShutdown() const;
     void checkShutdown() const;
@@ -148,9 +170,15 @@ private:
     std::shared_ptr<TraceLevels> _traceLevels;
     std::shared_ptr<CallbackExecutor> _executor;
     std::shared_ptr<Timer> _timer;
+    std::shared_ptr<PublishExecutor> _publishExecutor;
+    std::shared_ptr<MetricsAdminI> _metricsAdmin;
+    bool _metricsFacet;
+    bool _adminFacet;
+    std::string _flightRecorderFile;
     std::chrono::milliseconds _retryDelay;
     int _retryMultiplier;
     int _retryCount;
+    bool _compositeUpdates;
 
     mutable std::mutex _mutex;
     mutable std::condition_variable _cond;
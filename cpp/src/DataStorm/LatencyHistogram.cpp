@@ -0,0 +1,140 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/LatencyHistogram.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace DataStormI;
+
+namespace
+{
+
+const int subBucketBits = 7;
+const long long int subBucketCount = 1LL << subBucketBits;
+const long long int subBucketHalfCount = subBucketCount / 2;
+
+//
+// Latencies are clamped to about 1 hour which is more than enough for sample delivery latencies.
+//
+const int maxValueBits = 32;
+const long long int maxValue = (1LL << maxValueBits) - 1;
+const size_t bucketCount = static_cast<size_t>(subBucketCount + (maxValueBits - subBucketBits) * subBucketHalfCount);
+
+int
+highestBit(long long int value)
+{
+    int bit = 0;
+    while(value >>= 1)
+    {
+        ++bit;
+    }
+    return bit;
+}
+
+size_t
+indexOf(long long int value)
+{
+    if(value < subBucketCount)
+    {
+        return static_cast<size_t>(value);
+    }
+    int shift = highestBit(value) - subBucketBits + 1;
+    return static_cast<size_t>(subBucketCount + (shift - 1) * subBucketHalfCount +
+                               ((value >> shift) - subBucketHalfCount));
+}
+
+}
+
+LatencyHistogram::LatencyHistogram() :
+    _count(0),
+    _min(0),
+    _max(0),
+    _sum(0)
+{
+}
+
+void
+LatencyHistogram::record(chrono::microseconds latency)
+{
+    //
+    // The writer and reader clocks aren't necessarily synchronized, negative latencies are recorded as 0.
+    //
+    auto value = min(max(static_cast<long long int>(latency.count()), 0LL), maxValue);
+    if(_counts.empty())
+    {
+        _counts.resize(bucketCount);
+    }
+    ++_counts[indexOf(value)];
+    if(_count == 0 || value < _min)
+    {
+        _min = value;
+    }
+    if(value > _max)
+    {
+        _max = value;
+    }
+    _sum += value;
+    ++_count;
+}
+
+DataStorm::LatencyStatistics
+LatencyHistogram::getStatistics() const
+{
+    DataStorm::LatencyStatistics statistics;
+    statistics.count = _count;
+    if(_count > 0)
+    {
+        statistics.min = chrono::microseconds(_min);
+        statistics.max = chrono::microseconds(_max);
+        statistics.mean = chrono::microseconds(_sum / _count);
+        statistics.p50 = chrono::microseconds(percentile(50.0));
+        statistics.p90 = chrono::microseconds(percentile(90.0));
+        statistics.p99 = chrono::microseconds(percentile(99.0));
+        statistics.p999 = chrono::microseconds(percentile(99.9));
+    }
+    return statistics;
+}
+
+void
+LatencyHistogram::reset()
+{
+    fill(_counts.begin(), _counts.end(), 0);
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _sum = 0;
+}
+
+long long int
+LatencyHistogram::valueAt(size_t index) const
+{
+    //
+    // Returns the highest value recorded by the bucket at the given index.
+    //
+    auto i = static_cast<long long int>(index);
+    if(i < subBucketCount)
+    {
+        return i;
+    }
+    auto shift = (i - subBucketCount) / subBucketHalfCount + 1;
+    auto subBucket = (i - subBucketCount) % subBucketHalfCount + subBucketHalfCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+long long int
+LatencyHistogram::percentile(double percentile) const
+{
+    auto target = max(static_cast<long long int>(percentile / 100.0 * static_cast<double>(_count) + 0.5), 1LL);
+    long long int total = 0;
+    for(size_t i = 0; i < _counts.size(); ++i)
+    {
+        total += _counts[i];
+        if(total >= target)
+        {
+            return min(valueAt(i), _max);
+        }
+    }
+    return _max;
+}
@@ -0,0 +1,42 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/Types.h>
+
+#include <chrono>
+#include <vector>
+
+namespace DataStormI
+{
+
+//
+// Log-linear histogram of latencies in microseconds. Latencies below 128us are recorded exactly, larger
+// latencies are recorded in buckets of 64 sub-buckets for each power of 2 (a relative precision of about
+// 1.5%). Recording a value is a few arithmetic operations and an increment, the buckets are only allocated
+// when the first value is recorded. The histogram isn't thread safe.
+//
+class LatencyHistogram
+{
+public:
+
+    LatencyHistogram();
+
+    void record(std::chrono::microseconds);
+    DataStorm::LatencyStatistics getStatistics() const;
+    void reset();
+
+private:
+
+    long long int valueAt(size_t) const;
+    long long int percentile(double) const;
+
+    std::vector<long long int> _counts;
+    long long int _count;
+    long long int _min;
+    long long int _max;
+    long long int _sum;
+};
+
+}
@@ -60,6 +60,60 @@ LookupI::announceTopics(StringSeq readers, StringSeq writers, shared_ptr<NodePrx
     }
 }
 
+void
+LookupI::announceTopicsDelta(TopicNamesDelta delta, shared_ptr<NodePrx> proxy, const Ice::Current& current)
+{
+    if (proxy == nullptr)
+    {
+        return;
+    }
+    if(_nodeSessionManager->announceTopicsDelta(delta, proxy, current.con))
+    {
+        for(auto name : delta.addedReaders)
+        {
+            _topicFactory->createSubscriberSession(name, proxy, current.con);
+        }
+        for(auto name : delta.addedWriters)
+        {
+            _topicFactory->createPublisherSession(name, proxy, current.con);
+        }
+    }
+}
+
+bool
+LookupI::announceTopicsDigest(long long int digest, shared_ptr<NodePrx> proxy, const Ice::Current& current)
+{
+    if (proxy == nullptr)
+    {
+        return true;
+    }
+    StringSeq readers;
+    StringSeq writers;
+    if(!_nodeSessionManager->announceTopicsDigest(digest, proxy, current.con, readers, writers))
+    {
+        return false;
+    }
+    for(auto name : readers)
+    {
+        _topicFactory->createSubscriberSession(name, proxy, current.con);
+    }
+    for(auto name : writers)
+    {
+        _topicFactory->createPublisherSession(name, proxy, current.con);
+    }
+    return true;
+}
+
+void
+LookupI::requestTopicsResync(shared_ptr<NodePrx> proxy, const Ice::Current& current)
+{
+    if (proxy == nullptr)
+    {
+        return;
+    }
+    _nodeSessionManager->requestTopicsResync(proxy, current.con);
+}
+
 shared_ptr<NodePrx>
 LookupI::createSession(shared_ptr<NodePrx> node, const Ice::Current& current)
 {
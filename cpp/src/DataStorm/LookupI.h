@@ -32,6 +32,16 @@ public:
                                 std::shared_ptr<DataStormContract::NodePrx>,
                                 const Ice::Current&) override;
 
+    virtual void announceTopicsDelta(DataStormContract::TopicNamesDelta,
+                                     std::shared_ptr<DataStormContract::NodePrx>,
+                                     const Ice::Current&) override;
+
+    virtual bool announceTopicsDigest(long long int,
+                                      std::shared_ptr<DataStormContract::NodePrx>,
+                                      const Ice::Current&) override;
+
+    virtual void requestTopicsResync(std::shared_ptr<DataStormContract::NodePrx>, const Ice::Current&) override;
+
     virtual std::shared_ptr<DataStormContract::NodePrx> createSession(std::shared_ptr<DataStormContract::NodePrx>,
                                                                       const Ice::Current&) override;
 
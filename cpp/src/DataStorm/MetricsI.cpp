@@ -0,0 +1,35 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/MetricsI.h>
+#include <DataStorm/TopicFactoryI.h>
+#include <DataStorm/NodeI.h>
+#include <DataStorm/CallbackExecutor.h>
+
+using namespace std;
+using namespace DataStormI;
+
+MetricsAdminI::MetricsAdminI(shared_ptr<TopicFactoryI> factory,
+                             shared_ptr<NodeI> node,
+                             shared_ptr<CallbackExecutor> executor) :
+    _factory(move(factory)),
+    _node(move(node)),
+    _executor(move(executor))
+{
+}
+
+DataStorm::NodeMetrics
+MetricsAdminI::getMetrics(const Ice::Current&)
+{
+    return getMetrics();
+}
+
+DataStorm::NodeMetrics
+MetricsAdminI::getMetrics() const
+{
+    DataStorm::NodeMetrics metrics;
+    metrics.topics = _factory->getMetrics();
+    metrics.sessions = _node->getSessionMetrics();
+    metrics.callbackQueueDepth = static_cast<long long int>(_executor->getQueueSize());
+    return metrics;
+}
@@ -0,0 +1,32 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/Metrics.h>
+
+namespace DataStormI
+{
+
+class TopicFactoryI;
+class NodeI;
+class CallbackExecutor;
+
+class MetricsAdminI : public DataStorm::MetricsAdmin
+{
+public:
+
+    MetricsAdminI(std::shared_ptr<TopicFactoryI>, std::shared_ptr<NodeI>, std::shared_ptr<CallbackExecutor>);
+
+    virtual DataStorm::NodeMetrics getMetrics(const Ice::Current&) override;
+
+    DataStorm::NodeMetrics getMetrics() const;
+
+private:
+
+    const std::shared_ptr<TopicFactoryI> _factory;
+    const std::shared_ptr<NodeI> _node;
+    const std::shared_ptr<CallbackExecutor> _executor;
+};
+
+}
@@ -7,6 +7,7 @@
 #include <DataStorm/Instance.h>
 #include <DataStorm/TopicFactoryI.h>
 #include <DataStorm/NodeI.h>
+#include <DataStorm/MetricsI.h>
 
 using namespace std;
 using namespace DataStorm;
@@ -95,3 +96,9 @@ Node::getSessionConnection(const string& ident) const noexcept
 {
     return _instance ? _instance->getNode()->getSessionConnection(ident) : nullptr;
 }
+
+NodeMetrics
+Node::getMetrics() const noexcept
+{
+    return _instance ? _instance->getMetricsAdmin()->getMetrics() : NodeMetrics();
+}
@@ -68,9 +68,9 @@ NodeI::init()
 {
     auto self = shared_from_this();
     auto instance = getInstance();
-    auto forwarder = [self=shared_from_this()](Ice::ByteSeq e, const Ice::Current& c) { self->forward(e, c); };
-    _subscriberForwarder = Ice::uncheckedCast<SubscriberSessionPrx>(instance->getCollocatedForwarder()->add(forwarder));
-    _publisherForwarder = Ice::uncheckedCast<PublisherSessionPrx>(instance->getCollocatedForwarder()->add(forwarder));
+    auto self = shared_from_this();
+    _subscriberForwarder = Ice::uncheckedCast<SubscriberSessionPrx>(instance->getCollocatedForwarder()->add(self));
+    _publisherForwarder = Ice::uncheckedCast<PublisherSessionPrx>(instance->getCollocatedForwarder()->add(self));
     try
     {
         auto adapter = instance->getObjectAdapter();
@@ -187,6 +187,8 @@ NodeI::createSession(shared_ptr<NodePrx> subscriber,
                 connection->setAdapter(getInstance()->getObjectAdapter());
             }
 
+            // The writers with a lane establish their own connection with the session proxy endpoints
+            auto laneSession = subscriberSession;
             if(connection)
             {
                 subscriberSession = subscriberSession->ice_fixed(connection);
@@ -203,7 +205,10 @@ NodeI::createSession(shared_ptr<NodePrx> subscriber,
                                                 self->removePublisherSession(subscriber, session, ex);
                                              });
                 assert(!s->ice_getCachedConnection() || s->ice_getCachedConnection() == connection);
-                session->connected(subscriberSession, connection, getInstance()->getTopicFactory()->getTopicWriters());
+                session->connected(subscriberSession,
+                                   connection,
+                                   getInstance()->getTopicFactory()->getTopicWriters(),
+                                   laneSession);
             }
             catch(const Ice::LocalException&)
             {
@@ -409,6 +414,62 @@ NodeI::getSessionConnection(const string& id) const
     }
 }
 
+DataStorm::SessionMetricsSeq
+NodeI::getSessionMetrics() const
+{
+    vector<shared_ptr<SessionI>> subscribers;
+    vector<shared_ptr<SessionI>> publishers;
+    getSessions(subscribers, publishers);
+
+    DataStorm::SessionMetricsSeq metrics;
+    metrics.reserve(subscribers.size() + publishers.size());
+    for(const auto& session : subscribers)
+    {
+        metrics.push_back(session->getMetrics());
+    }
+    for(const auto& session : publishers)
+    {
+        metrics.push_back(session->getMetrics());
+        metrics.back().publisher = true;
+    }
+    return metrics;
+}
+
+DataStorm::SessionDescriptionSeq
+NodeI::getSessionDescriptions() const
+{
+    vector<shared_ptr<SessionI>> subscribers;
+    vector<shared_ptr<SessionI>> publishers;
+    getSessions(subscribers, publishers);
+
+    DataStorm::SessionDescriptionSeq descriptions;
+    descriptions.reserve(subscribers.size() + publishers.size());
+    for(const auto& session : subscribers)
+    {
+        descriptions.push_back(session->describe());
+    }
+    for(const auto& session : publishers)
+    {
+        descriptions.push_back(session->describe());
+        descriptions.back().publisher = true;
+    }
+    return descriptions;
+}
+
+void
+NodeI::getSessions(vector<shared_ptr<SessionI>>& subscribers, vector<shared_ptr<SessionI>>& publishers) const
+{
+    unique_lock<mutex> lock(_mutex);
+    for(const auto& p : _subscriberSessions)
+    {
+        subscribers.push_back(p.second);
+    }
+    for(const auto& p : _publisherSessions)
+    {
+        publishers.push_back(p.second);
+    }
+}
+
 shared_ptr<SessionI>
 NodeI::getSession(const Ice::Identity& ident) const
 {
@@ -432,6 +493,20 @@ NodeI::getSession(const Ice::Identity& ident) const
     return nullptr;
 }
 
+void
+NodeI::addLane(int lane)
+{
+    lock_guard<mutex> lock(_lanesMutex);
+    _lanes.insert(lane);
+}
+
+set<int>
+NodeI::getLanes() const
+{
+    lock_guard<mutex> lock(_lanesMutex);
+    return _lanes;
+}
+
 shared_ptr<SubscriberSessionI>
 NodeI::createSubscriberSessionServant(const shared_ptr<NodePrx>& node)
 {
@@ -6,6 +6,8 @@
 #include <DataStorm/InternalI.h>
 #include <DataStorm/ForwarderManager.h>
 #include <DataStorm/Contract.h>
+#include <DataStorm/Admin.h>
+#include <DataStorm/Metrics.h>
 
 #include <Ice/Ice.h>
 
@@ -20,7 +22,7 @@ class SessionI;
 class PublisherSessionI;
 class SubscriberSessionI;
 
-class NodeI : virtual public DataStormContract::Node, public std::enable_shared_from_this<NodeI>
+class NodeI : virtual public DataStormContract::Node, public Forwarder, public std::enable_shared_from_this<NodeI>
 {
 
 public:
@@ -62,6 +64,12 @@ public:
 
     std::shared_ptr<SessionI> getSession(const Ice::Identity&) const;
 
+    void addLane(int);
+    std::set<int> getLanes() const;
+
+    DataStorm::SessionMetricsSeq getSessionMetrics() const;
+    DataStorm::SessionDescriptionSeq getSessionDescriptions() const;
+
     std::shared_ptr<DataStormContract::NodePrx>
     getNodeWithExistingConnection(const std::shared_ptr<DataStormContract::NodePrx>&,
                                   const std::shared_ptr<Ice::Connection>&);
@@ -96,7 +104,8 @@ private:
     std::shared_ptr<PublisherSessionI>
     createPublisherSessionServant(const std::shared_ptr<DataStormContract::NodePrx>&);
 
-    void forward(const Ice::ByteSeq&, const Ice::Current&) const;
+    void getSessions(std::vector<std::shared_ptr<SessionI>>&, std::vector<std::shared_ptr<SessionI>>&) const;
+    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const override;
 
     mutable std::mutex _mutex;
     mutable std::condition_variable _cond;
@@ -110,6 +119,10 @@ private:
     std::map<Ice::Identity, std::shared_ptr<PublisherSessionI>> _publisherSessions;
     long long int _nextSubscriberSessionId;
     long long int _nextPublisherSessionId;
+
+    // The lanes of the node writers, the lanes mutex can be locked with any other mutex locked
+    mutable std::mutex _lanesMutex;
+    std::set<int> _lanes;
 };
 
 }
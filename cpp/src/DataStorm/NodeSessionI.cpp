@@ -221,3 +221,11 @@ NodeSessionI::forwarder(const std::shared_ptr<SessionPrx>& session) const
                                                               id.category + 'f' });
     return Ice::uncheckedCast<SessionPrx>(proxy->ice_oneway());
 }
+
+bool
+NodeSessionI::isSessionForwarder(const shared_ptr<Ice::ObjectPrx>& proxy)
+{
+    // The forwarder category is the session category followed by 'f', see forwarder() above
+    const auto& category = proxy->ice_getIdentity().category;
+    return category.size() == 2 && category[1] == 'f';
+}
@@ -34,6 +34,8 @@ public:
         return Ice::uncheckedCast<T>(forwarder(session));
     }
 
+    static bool isSessionForwarder(const std::shared_ptr<Ice::ObjectPrx>&);
+
 private:
 
     std::shared_ptr<DataStormContract::SessionPrx>
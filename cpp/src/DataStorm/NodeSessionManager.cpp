@@ -18,7 +18,42 @@ using namespace DataStormContract;
 namespace
 {
 
-class SessionForwarderI : public Ice::Blobject
+//
+// The digest of topic names must be identical on all the nodes so we can't rely on std::hash, the 64-bit
+// FNV-1a hash is used instead.
+//
+long long int
+hashTopicName(char kind, const string& name)
+{
+    unsigned long long int hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<unsigned char>(kind)) * 1099511628211ULL;
+    for(auto c : name)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return static_cast<long long int>(hash);
+}
+
+//
+// The topic names of the peers received over multicast are discarded if not updated for this duration since
+// the multicast connection is never closed. If the peer is still alive, its names are resynced on its next delta.
+//
+const chrono::minutes multicastPeerTopicsExpiry(10);
+
+bool
+isDatagram(const shared_ptr<Ice::Connection>& connection)
+{
+    return connection && connection->type() == "udp";
+}
+
+set<string>
+getRelayTopics(const shared_ptr<Instance>& instance)
+{
+    auto topics = instance->getCommunicator()->getProperties()->getPropertyAsList("DataStorm.Node.Relay.Topics");
+    return set<string>(topics.begin(), topics.end());
+}
+
+class SessionForwarderI : public Ice::BlobjectAsync
 {
 public:
 
@@ -27,8 +62,11 @@ public:
     {
     }
 
-    virtual bool
-    ice_invoke(Ice::ByteSeq inEncaps, Ice::ByteSeq&, const Ice::Current& curr)
+    virtual void
+    ice_invokeAsync(Ice::ByteSeq inEncaps,
+                    function<void(bool, const Ice::ByteSeq&)> response,
+                    function<void(exception_ptr)> exception,
+                    const Ice::Current& curr)
     {
         auto pos = curr.id.name.find('-');
         if(pos != string::npos && pos < curr.id.name.length())
@@ -36,9 +74,31 @@ public:
             auto s = _nodeSessionManager->getSession(curr.id.name.substr(pos + 1));
             if(s)
             {
+                //
+                // The request is acknowledged once it's written to the node session connection rather than once
+                // it's dispatched: writers with backlog limits invoke the forwarder with a twoway proxy to account
+                // for the forwarded samples in the listener backlog. The invocation completes only once.
+                //
+                auto completed = make_shared<atomic_flag>();
+                completed->clear();
                 auto id = Ice::Identity { curr.id.name.substr(0, pos), curr.id.category.substr(0, 1) };
-                s->getConnection()->createProxy(id)->ice_invokeAsync(curr.operation, curr.mode, inEncaps, curr.ctx);
-                return true;
+                s->getConnection()->createProxy(id)->ice_invokeAsync(curr.operation, curr.mode, inEncaps, nullptr,
+                    [exception, completed](exception_ptr ex)
+                    {
+                        if(!completed->test_and_set())
+                        {
+                            exception(ex);
+                        }
+                    },
+                    [response, completed](bool)
+                    {
+                        if(!completed->test_and_set())
+                        {
+                            response(true, Ice::ByteSeq());
+                        }
+                    },
+                    curr.ctx);
+                return;
             }
         }
         throw Ice::ObjectNotExistException(__FILE__, __LINE__, curr.id, curr.facet, curr.operation);
@@ -57,17 +117,84 @@ NodeSessionManager::NodeSessionManager(const shared_ptr<Instance>& instance, con
     _nodePrx(node->getProxy()),
     _forwardToMulticast(instance->getCommunicator()->getProperties()->getPropertyAsInt(
         "DataStorm.Node.Server.ForwardDiscoveryToMulticast") > 0),
+    _relayTopics(getRelayTopics(instance)),
     _retryCount(0)
 {
 }
 
+NodeSessionManager::TopicNames::TopicNames() : version(0), digest(0), synced(false)
+{
+}
+
+TopicNamesDelta
+NodeSessionManager::TopicNames::getFullDelta() const
+{
+    TopicNamesDelta delta;
+    delta.version = version;
+    delta.digest = digest;
+    delta.full = true;
+    delta.addedReaders.assign(readers.begin(), readers.end());
+    delta.addedWriters.assign(writers.begin(), writers.end());
+    return delta;
+}
+
+StringSeq
+NodeSessionManager::TopicNames::addReaders(const StringSeq& names)
+{
+    return update(readers, 'r', names, true);
+}
+
+StringSeq
+NodeSessionManager::TopicNames::addWriters(const StringSeq& names)
+{
+    return update(writers, 'w', names, true);
+}
+
+StringSeq
+NodeSessionManager::TopicNames::removeReaders(const StringSeq& names)
+{
+    return update(readers, 'r', names, false);
+}
+
+StringSeq
+NodeSessionManager::TopicNames::removeWriters(const StringSeq& names)
+{
+    return update(writers, 'w', names, false);
+}
+
+void
+NodeSessionManager::TopicNames::clear()
+{
+    digest = 0;
+    readers.clear();
+    writers.clear();
+}
+
+StringSeq
+NodeSessionManager::TopicNames::update(set<string>& names, char kind, const StringSeq& updated, bool add)
+{
+    //
+    // The digest is the XOR of the name hashes, it doesn't depend on the order in which names are added or
+    // removed and it can be updated incrementally.
+    //
+    StringSeq changed;
+    for(const auto& name : updated)
+    {
+        if(add ? names.insert(name).second : names.erase(name) > 0)
+        {
+            digest ^= hashTopicName(kind, name);
+            changed.push_back(name);
+        }
+    }
+    return changed;
+}
+
 void
 NodeSessionManager::init()
 {
     auto instance = getInstance();
 
-    auto forwarder = [self=shared_from_this()](Ice::ByteSeq e, const Ice::Current& c) { self->forward(e, c); };
-    _forwarder = Ice::uncheckedCast<LookupPrx>(instance->getCollocatedForwarder()->add(move(forwarder)));
+    _forwarder = Ice::uncheckedCast<LookupPrx>(instance->getCollocatedForwarder()->add(shared_from_this()));
 
     try
     {
@@ -121,6 +248,7 @@ NodeSessionManager::createOrGet(const shared_ptr<NodePrx>& node,
 
     instance->getConnectionManager()->add(node, connection, [=, self=shared_from_this()](auto connection, auto ex)
     {
+        self->removeConnection(connection);
         self->destroySession(node);
     });
 
@@ -137,6 +265,10 @@ NodeSessionManager::announceTopicReader(const string& topic,
     {
         return; // Ignore requests from self
     }
+    else if(_relayTopics.find(topic) != _relayTopics.end())
+    {
+        return; // Relayed topics are only announced by the local relay
+    }
 
     if(_traceLevels->session > 1)
     {
@@ -179,6 +311,10 @@ NodeSessionManager::announceTopicWriter(const string& topic,
     {
         return; // Ignore requests from self
     }
+    else if(_relayTopics.find(topic) != _relayTopics.end())
+    {
+        return; // Relayed topics are only announced by the local relay
+    }
 
     if(_traceLevels->session > 1)
     {
@@ -211,8 +347,8 @@ NodeSessionManager::announceTopicWriter(const string& topic,
 }
 
 void
-NodeSessionManager::announceTopics(const StringSeq& readers,
-                                   const StringSeq& writers,
+NodeSessionManager::announceTopics(const StringSeq& announcedReaders,
+                                   const StringSeq& announcedWriters,
                                    const shared_ptr<NodePrx>& node,
                                    const shared_ptr<Ice::Connection>& connection) const
 {
@@ -222,6 +358,13 @@ NodeSessionManager::announceTopics(const StringSeq& readers,
         return; // Ignore requests from self
     }
 
+    auto readers = filterRelayTopics(announcedReaders);
+    auto writers = filterRelayTopics(announcedWriters);
+    if(readers.empty() && writers.empty())
+    {
+        return; // Relayed topics are only announced by the local relay
+    }
+
     if(_traceLevels->session > 1)
     {
         Trace out(_traceLevels, _traceLevels->sessionCat);
@@ -266,6 +409,225 @@ NodeSessionManager::announceTopics(const StringSeq& readers,
     }
 }
 
+void
+NodeSessionManager::announceTopicsDelta(const StringSeq& addedReaders,
+                                        const StringSeq& addedWriters,
+                                        const StringSeq& removedReaders,
+                                        const StringSeq& removedWriters)
+{
+    unique_lock<mutex> lock(_mutex);
+
+    TopicNamesDelta delta;
+    delta.addedReaders = _topics.addReaders(addedReaders);
+    delta.addedWriters = _topics.addWriters(addedWriters);
+    delta.removedReaders = _topics.removeReaders(removedReaders);
+    delta.removedWriters = _topics.removeWriters(removedWriters);
+    if(delta.addedReaders.empty() && delta.addedWriters.empty() &&
+       delta.removedReaders.empty() && delta.removedWriters.empty())
+    {
+        return;
+    }
+    delta.version = ++_topics.version;
+    delta.digest = _topics.digest;
+    delta.full = false;
+
+    if(_traceLevels->session > 1)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << "announcing topics delta v" << delta.version;
+        if(!delta.addedReaders.empty())
+        {
+            out << "\nadded reader(s) `" << delta.addedReaders << "'";
+        }
+        if(!delta.addedWriters.empty())
+        {
+            out << "\nadded writer(s) `" << delta.addedWriters << "'";
+        }
+        if(!delta.removedReaders.empty())
+        {
+            out << "\nremoved reader(s) `" << delta.removedReaders << "'";
+        }
+        if(!delta.removedWriters.empty())
+        {
+            out << "\nremoved writer(s) `" << delta.removedWriters << "'";
+        }
+    }
+
+    _exclude = nullptr;
+    _forwarder->announceTopicsDelta(delta, _nodePrx);
+    announceLegacyTopics(delta.addedReaders, delta.addedWriters, _nodePrx);
+
+    lock.unlock();
+
+    auto instance = _instance.lock();
+    if(instance && instance->getLookup())
+    {
+        instance->getLookup()->announceTopicsDeltaAsync(delta, _nodePrx);
+    }
+}
+
+bool
+NodeSessionManager::announceTopicsDelta(const TopicNamesDelta& delta,
+                                        const shared_ptr<NodePrx>& node,
+                                        const shared_ptr<Ice::Connection>& connection)
+{
+    unique_lock<mutex> lock(_mutex);
+    if(node->ice_getIdentity() == _nodePrx->ice_getIdentity())
+    {
+        return false; // Ignore requests from self
+    }
+
+    if(isDatagram(connection))
+    {
+        expirePeerTopics();
+    }
+
+    auto& names = _peerTopics[node->ice_getIdentity()];
+    if(delta.version <= names.version && !delta.full)
+    {
+        return false; // Already applied, the delta was also received from another peer
+    }
+    names.node = node;
+    names.connection = connection;
+    names.updated = chrono::steady_clock::now();
+
+    //
+    // Forward the changes rather than the full delta if the names of the node were known and in sync, this
+    // ensures a reconnecting node which resyncs its names doesn't cause a broadcast of all its names.
+    //
+    TopicNamesDelta forwarded;
+    forwarded.version = delta.version;
+    if(delta.full)
+    {
+        auto previousReaders = names.readers;
+        auto previousWriters = names.writers;
+        auto wasSynced = names.synced;
+        names.clear();
+        forwarded.addedReaders = names.addReaders(delta.addedReaders);
+        forwarded.addedWriters = names.addWriters(delta.addedWriters);
+        if(wasSynced)
+        {
+            auto diff = [](const set<string>& previous,
+                           const set<string>& current,
+                           StringSeq& added,
+                           StringSeq& removed)
+            {
+                StringSeq newNames;
+                for(const auto& name : added)
+                {
+                    if(previous.find(name) == previous.end())
+                    {
+                        newNames.push_back(name);
+                    }
+                }
+                added.swap(newNames);
+                for(const auto& name : previous)
+                {
+                    if(current.find(name) == current.end())
+                    {
+                        removed.push_back(name);
+                    }
+                }
+            };
+            diff(previousReaders, names.readers, forwarded.addedReaders, forwarded.removedReaders);
+            diff(previousWriters, names.writers, forwarded.addedWriters, forwarded.removedWriters);
+        }
+        forwarded.full = !wasSynced;
+    }
+    else
+    {
+        forwarded.addedReaders = names.addReaders(delta.addedReaders);
+        forwarded.addedWriters = names.addWriters(delta.addedWriters);
+        forwarded.removedReaders = names.removeReaders(delta.removedReaders);
+        forwarded.removedWriters = names.removeWriters(delta.removedWriters);
+        forwarded.full = false;
+    }
+    names.version = delta.version;
+    names.synced = names.digest == delta.digest;
+
+    if(_traceLevels->session > 1)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << "topics delta v" << delta.version << (delta.full ? " (full)" : "") << " announced (peer = `" << node
+            << "')";
+        if(!names.synced)
+        {
+            out << "\ntopic names are out of sync, requesting resync";
+        }
+    }
+
+    if(!names.synced)
+    {
+        requestResync(node, connection);
+    }
+
+    forwarded.addedReaders = filterRelayTopics(forwarded.addedReaders);
+    forwarded.addedWriters = filterRelayTopics(forwarded.addedWriters);
+    forwarded.removedReaders = filterRelayTopics(forwarded.removedReaders);
+    forwarded.removedWriters = filterRelayTopics(forwarded.removedWriters);
+    forwarded.digest = filterRelayDigest(names, delta.digest);
+    if(forwarded.full || !forwarded.addedReaders.empty() || !forwarded.addedWriters.empty() ||
+       !forwarded.removedReaders.empty() || !forwarded.removedWriters.empty())
+    {
+        _exclude = connection;
+        auto p = _sessions.find(node->ice_getIdentity());
+        auto nodePrx = p != _sessions.end() ? p->second->getPublicNode() : node;
+        _forwarder->announceTopicsDelta(forwarded, nodePrx);
+        announceLegacyTopics(forwarded.addedReaders, forwarded.addedWriters, nodePrx);
+
+        lock.unlock();
+
+        if(connection && _forwardToMulticast && connection->type() != "udp")
+        {
+            auto instance = _instance.lock();
+            if(instance && instance->getLookup())
+            {
+                instance->getLookup()->announceTopicsDeltaAsync(forwarded, nodePrx);
+            }
+        }
+    }
+    return true;
+}
+
+bool
+NodeSessionManager::announceTopicsDigest(long long int digest,
+                                         const shared_ptr<NodePrx>& node,
+                                         const shared_ptr<Ice::Connection>&,
+                                         StringSeq& readers,
+                                         StringSeq& writers)
+{
+    unique_lock<mutex> lock(_mutex);
+    if(node->ice_getIdentity() == _nodePrx->ice_getIdentity())
+    {
+        return true; // Ignore requests from self
+    }
+
+    auto p = _peerTopics.find(node->ice_getIdentity());
+    if(p == _peerTopics.end() || !p->second.synced || p->second.digest != digest)
+    {
+        if(_traceLevels->session > 1)
+        {
+            Trace out(_traceLevels, _traceLevels->sessionCat);
+            out << "topics digest announced, unknown topic names (peer = `" << node << "')";
+        }
+        return false;
+    }
+
+    if(_traceLevels->session > 1)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << "topics digest announced, topic names up to date (peer = `" << node << "')";
+    }
+
+    //
+    // The digest isn't forwarded, peers already know the topic names and the sessions with the node are
+    // re-established by the session retry.
+    //
+    readers.assign(p->second.readers.begin(), p->second.readers.end());
+    writers.assign(p->second.writers.begin(), p->second.writers.end());
+    return true;
+}
+
 shared_ptr<NodeSessionI>
 NodeSessionManager::getSession(const Ice::Identity& node) const
 {
@@ -281,6 +643,43 @@ NodeSessionManager::getSession(const Ice::Identity& node) const
 void
 NodeSessionManager::forward(const Ice::ByteSeq& inEncaps, const Ice::Current& current) const
 {
+    //
+    // The topic names deltas aren't forwarded to the peers which don't support them, the added names are announced
+    // to these peers with announceTopics instead (see announceLegacyTopics). A peer is detected as not supporting
+    // deltas if the forwarded delta fails with OperationNotExistException.
+    //
+    bool delta = current.operation == "announceTopicsDelta";
+    auto invoke = [&](const shared_ptr<LookupPrx>& lookup, const shared_ptr<Ice::Connection>& connection)
+    {
+        if(!delta)
+        {
+            lookup->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
+        }
+        else if(_legacyLookups.find(connection) == _legacyLookups.end())
+        {
+            lookup->ice_invokeAsync(current.operation,
+                                    current.mode,
+                                    inEncaps,
+                                    [](bool, const vector<Ice::Byte>&) {},
+                                    [=, self=shared_from_this()](exception_ptr ex)
+                                    {
+                                        try
+                                        {
+                                            rethrow_exception(ex);
+                                        }
+                                        catch(const Ice::OperationNotExistException&)
+                                        {
+                                            self->legacyPeer(lookup, connection);
+                                        }
+                                        catch(const std::exception&)
+                                        {
+                                        }
+                                    },
+                                    nullptr,
+                                    current.ctx);
+        }
+    };
+
     for(const auto& session : _sessions)
     {
         if(session.second->getConnection() != _exclude)
@@ -288,15 +687,16 @@ NodeSessionManager::forward(const Ice::ByteSeq& inEncaps, const Ice::Current& cu
             auto l = session.second->getLookup();
             if(l)
             {
-                l->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
+                invoke(l, session.second->getConnection());
             }
         }
     }
     for(const auto& lookup : _connectedTo)
     {
-        if(lookup.second.second->ice_getCachedConnection() != _exclude)
+        auto connection = lookup.second.second->ice_getCachedConnection();
+        if(connection != _exclude)
         {
-            lookup.second.second->ice_invokeAsync(current.operation, current.mode, inEncaps, current.ctx);
+            invoke(lookup.second.second, connection);
         }
     }
 }
@@ -351,18 +751,213 @@ NodeSessionManager::connected(const shared_ptr<NodePrx>& node, const shared_ptr<
 
     instance->getConnectionManager()->add(lookup, connection, [=, self=shared_from_this()](auto connection, auto ex)
     {
-        disconnected(node, lookup);
+        self->removeConnection(connection);
+        self->disconnected(node, lookup);
     });
     auto l = p != _sessions.end() ? lookup->ice_fixed(connection) : lookup;
     _connectedTo.emplace(node->ice_getIdentity(), make_pair(node, l));
 
-    auto readerNames = instance->getTopicFactory()->getTopicReaderNames();
-    auto writerNames = instance->getTopicFactory()->getTopicWriterNames();
-    if(!readerNames.empty() || !writerNames.empty())
+    //
+    // Announce the digest of the topic names, the topic names are only sent if the peer doesn't already know
+    // them (if it's the first time we connect to the peer or if the topic names changed while disconnected).
+    //
+    if(!_topics.readers.empty() || !_topics.writers.empty())
+    {
+        try
+        {
+            l->announceTopicsDigestAsync(_topics.digest,
+                                         _nodePrx,
+                                         [=, self=shared_from_this()](bool known)
+                                         {
+                                             if(!known)
+                                             {
+                                                 resync(l);
+                                             }
+                                         },
+                                         [=, self=shared_from_this()](exception_ptr ex)
+                                         {
+                                             try
+                                             {
+                                                 rethrow_exception(ex);
+                                             }
+                                             catch(const Ice::OperationNotExistException&)
+                                             {
+                                                 legacyPeer(l, connection);
+                                             }
+                                             catch(const std::exception&)
+                                             {
+                                             }
+                                         });
+        }
+        catch(const Ice::ObjectAdapterDeactivatedException&)
+        {
+        }
+        catch(const Ice::CommunicatorDestroyedException&)
+        {
+        }
+    }
+}
+
+void
+NodeSessionManager::resync(const shared_ptr<LookupPrx>& lookup)
+{
+    unique_lock<mutex> lock(_mutex);
+    auto delta = _topics.getFullDelta();
+    lock.unlock();
+
+    try
+    {
+        lookup->announceTopicsDeltaAsync(delta, _nodePrx);
+    }
+    catch(const Ice::ObjectAdapterDeactivatedException&)
+    {
+    }
+    catch(const Ice::CommunicatorDestroyedException&)
+    {
+    }
+}
+
+void
+NodeSessionManager::requestResync(const shared_ptr<NodePrx>& node, const shared_ptr<Ice::Connection>& connection)
+{
+    //
+    // Called with _mutex locked. The resync of the node topic names is requested from the peer the delta was
+    // received from. Requests received over multicast are only answered by the node itself.
+    //
+    try
+    {
+        shared_ptr<LookupPrx> lookup;
+        if(isDatagram(connection))
+        {
+            auto instance = _instance.lock();
+            lookup = instance ? instance->getLookup() : nullptr;
+        }
+        else if(connection)
+        {
+            lookup = Ice::uncheckedCast<LookupPrx>(connection->createProxy({ "Lookup", "DataStorm" }));
+        }
+
+        if(lookup)
+        {
+            lookup->requestTopicsResyncAsync(node, nullptr, [](exception_ptr) {});
+        }
+    }
+    catch(const Ice::LocalException&)
+    {
+    }
+}
+
+void
+NodeSessionManager::requestTopicsResync(const shared_ptr<NodePrx>& node, const shared_ptr<Ice::Connection>& connection)
+{
+    unique_lock<mutex> lock(_mutex);
+    TopicNamesDelta delta;
+    shared_ptr<NodePrx> nodePrx;
+    if(node->ice_getIdentity() == _nodePrx->ice_getIdentity())
+    {
+        delta = _topics.getFullDelta();
+        nodePrx = _nodePrx;
+    }
+    else
+    {
+        auto p = _peerTopics.find(node->ice_getIdentity());
+        if(isDatagram(connection) || p == _peerTopics.end())
+        {
+            return;
+        }
+        else if(!p->second.synced)
+        {
+            //
+            // Our names of the node are out of sync as well, the request is forwarded to the peer the names were
+            // received from. The resync will be forwarded back with the full delta once received.
+            //
+            if(p->second.connection != connection && !isDatagram(p->second.connection))
+            {
+                requestResync(node, p->second.connection);
+            }
+            return;
+        }
+        delta = getForwardedFullDelta(p->second);
+        nodePrx = getPublicNode(p->second.node);
+    }
+
+    if(_traceLevels->session > 1)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << "topics resync requested (node = `" << node << "')";
+    }
+
+    shared_ptr<LookupPrx> lookup;
+    if(isDatagram(connection))
+    {
+        auto instance = _instance.lock();
+        lookup = instance ? instance->getLookup() : nullptr;
+    }
+    else if(connection)
+    {
+        lookup = Ice::uncheckedCast<LookupPrx>(connection->createProxy({ "Lookup", "DataStorm" }));
+    }
+    lock.unlock();
+
+    if(lookup)
+    {
+        try
+        {
+            lookup->announceTopicsDeltaAsync(delta, nodePrx);
+        }
+        catch(const Ice::ObjectAdapterDeactivatedException&)
+        {
+        }
+        catch(const Ice::CommunicatorDestroyedException&)
+        {
+        }
+    }
+}
+
+void
+NodeSessionManager::legacyPeer(const shared_ptr<LookupPrx>& lookup, const shared_ptr<Ice::Connection>& connection) const
+{
+    unique_lock<mutex> lock(_mutex);
+    if(!connection || !_legacyLookups.emplace(connection, lookup).second)
+    {
+        return;
+    }
+
+    if(_traceLevels->session > 0)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << "peer doesn't support topic names deltas, using topic announcements:\n" << connection->toString();
+    }
+
+    //
+    // The peer missed the deltas, announce all the known topic names.
+    //
+    vector<tuple<StringSeq, StringSeq, shared_ptr<NodePrx>>> announcements;
+    if(!_topics.readers.empty() || !_topics.writers.empty())
+    {
+        announcements.emplace_back(StringSeq(_topics.readers.begin(), _topics.readers.end()),
+                                   StringSeq(_topics.writers.begin(), _topics.writers.end()),
+                                   _nodePrx);
+    }
+    for(const auto& p : _peerTopics)
+    {
+        if(p.second.connection != connection && p.second.node)
+        {
+            auto readers = filterRelayTopics(StringSeq(p.second.readers.begin(), p.second.readers.end()));
+            auto writers = filterRelayTopics(StringSeq(p.second.writers.begin(), p.second.writers.end()));
+            if(!readers.empty() || !writers.empty())
+            {
+                announcements.emplace_back(move(readers), move(writers), getPublicNode(p.second.node));
+            }
+        }
+    }
+    lock.unlock();
+
+    for(const auto& announcement : announcements)
     {
         try
         {
-            l->announceTopicsAsync(readerNames, writerNames, _nodePrx);
+            lookup->announceTopicsAsync(get<0>(announcement), get<1>(announcement), get<2>(announcement));
         }
         catch(const Ice::ObjectAdapterDeactivatedException&)
         {
@@ -373,6 +968,76 @@ NodeSessionManager::connected(const shared_ptr<NodePrx>& node, const shared_ptr<
     }
 }
 
+void
+NodeSessionManager::announceLegacyTopics(const StringSeq& readers,
+                                         const StringSeq& writers,
+                                         const shared_ptr<NodePrx>& node) const
+{
+    //
+    // Called with _mutex locked. The removed names can't be announced to peers which don't support deltas, these
+    // peers only learn about new names.
+    //
+    if(readers.empty() && writers.empty())
+    {
+        return;
+    }
+
+    for(const auto& p : _legacyLookups)
+    {
+        if(p.first != _exclude)
+        {
+            try
+            {
+                p.second->announceTopicsAsync(readers, writers, node);
+            }
+            catch(const Ice::ObjectAdapterDeactivatedException&)
+            {
+            }
+            catch(const Ice::CommunicatorDestroyedException&)
+            {
+            }
+        }
+    }
+}
+
+void
+NodeSessionManager::removeConnection(const shared_ptr<Ice::Connection>& connection)
+{
+    lock_guard<mutex> lock(_mutex);
+    _legacyLookups.erase(connection);
+    for(auto p = _peerTopics.begin(); p != _peerTopics.end();)
+    {
+        if(p->second.connection == connection)
+        {
+            p = _peerTopics.erase(p);
+        }
+        else
+        {
+            ++p;
+        }
+    }
+}
+
+void
+NodeSessionManager::expirePeerTopics()
+{
+    //
+    // Called with _mutex locked.
+    //
+    auto expired = chrono::steady_clock::now() - multicastPeerTopicsExpiry;
+    for(auto p = _peerTopics.begin(); p != _peerTopics.end();)
+    {
+        if(isDatagram(p->second.connection) && p->second.updated < expired)
+        {
+            p = _peerTopics.erase(p);
+        }
+        else
+        {
+            ++p;
+        }
+    }
+}
+
 void
 NodeSessionManager::disconnected(const shared_ptr<NodePrx>& node, const shared_ptr<LookupPrx>& lookup)
 {
@@ -422,3 +1087,59 @@ NodeSessionManager::destroySession(const shared_ptr<NodePrx>& node)
     p->second->destroy();
     _sessions.erase(p);
 }
+
+StringSeq
+NodeSessionManager::filterRelayTopics(const StringSeq& topics) const
+{
+    if(_relayTopics.empty())
+    {
+        return topics;
+    }
+
+    StringSeq filtered;
+    for(const auto& topic : topics)
+    {
+        if(_relayTopics.find(topic) == _relayTopics.end())
+        {
+            filtered.push_back(topic);
+        }
+    }
+    return filtered;
+}
+
+long long int
+NodeSessionManager::filterRelayDigest(const TopicNames& names, long long int digest) const
+{
+    //
+    // The relayed topic names aren't forwarded, the forwarded digest must not include them.
+    //
+    for(const auto& topic : _relayTopics)
+    {
+        if(names.readers.find(topic) != names.readers.end())
+        {
+            digest ^= hashTopicName('r', topic);
+        }
+        if(names.writers.find(topic) != names.writers.end())
+        {
+            digest ^= hashTopicName('w', topic);
+        }
+    }
+    return digest;
+}
+
+TopicNamesDelta
+NodeSessionManager::getForwardedFullDelta(const TopicNames& names) const
+{
+    auto delta = names.getFullDelta();
+    delta.addedReaders = filterRelayTopics(delta.addedReaders);
+    delta.addedWriters = filterRelayTopics(delta.addedWriters);
+    delta.digest = filterRelayDigest(names, delta.digest);
+    return delta;
+}
+
+shared_ptr<NodePrx>
+NodeSessionManager::getPublicNode(const shared_ptr<NodePrx>& node) const
+{
+    auto p = _sessions.find(node->ice_getIdentity());
+    return p != _sessions.end() ? p->second->getPublicNode() : node;
+}
@@ -5,6 +5,7 @@
 
 #include <DataStorm/Config.h>
 #include <DataStorm/Contract.h>
+#include <DataStorm/ForwarderManager.h>
 
 #include <Ice/Ice.h>
 
@@ -17,7 +18,7 @@ class Instance;
 class TraceLevels;
 class NodeI;
 
-class NodeSessionManager : public std::enable_shared_from_this<NodeSessionManager>
+class NodeSessionManager : public Forwarder, public std::enable_shared_from_this<NodeSessionManager>
 {
 public:
 
@@ -41,16 +42,79 @@ public:
                         const std::shared_ptr<DataStormContract::NodePrx>&,
                         const std::shared_ptr<Ice::Connection>& = nullptr) const;
 
+    void announceTopicsDelta(const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&);
+
+    bool announceTopicsDelta(const DataStormContract::TopicNamesDelta&,
+                             const std::shared_ptr<DataStormContract::NodePrx>&,
+                             const std::shared_ptr<Ice::Connection>&);
+
+    bool announceTopicsDigest(long long int,
+                              const std::shared_ptr<DataStormContract::NodePrx>&,
+                              const std::shared_ptr<Ice::Connection>&,
+                              DataStormContract::StringSeq&,
+                              DataStormContract::StringSeq&);
+
+    void requestTopicsResync(const std::shared_ptr<DataStormContract::NodePrx>&,
+                             const std::shared_ptr<Ice::Connection>&);
+
     std::shared_ptr<NodeSessionI> getSession(const Ice::Identity&) const;
     std::shared_ptr<NodeSessionI> getSession(const std::string& name) const
     {
         return getSession(Ice::Identity { name, ""});
     }
 
-    void forward(const Ice::ByteSeq&, const Ice::Current&) const;
+    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const override;
 
 private:
 
+    //
+    // The topic reader and writer names of a node along with the version of the last applied delta and an order
+    // independent digest of the names. The connection is the one the last delta was received from, the names are
+    // discarded when it's closed.
+    //
+    class TopicNames
+    {
+    public:
+
+        TopicNames();
+
+        DataStormContract::StringSeq addReaders(const DataStormContract::StringSeq&);
+        DataStormContract::StringSeq addWriters(const DataStormContract::StringSeq&);
+        DataStormContract::StringSeq removeReaders(const DataStormContract::StringSeq&);
+        DataStormContract::StringSeq removeWriters(const DataStormContract::StringSeq&);
+        void clear();
+
+        DataStormContract::TopicNamesDelta getFullDelta() const;
+
+        long long int version;
+        long long int digest;
+        bool synced;
+        std::set<std::string> readers;
+        std::set<std::string> writers;
+        std::shared_ptr<DataStormContract::NodePrx> node;
+        std::shared_ptr<Ice::Connection> connection;
+        std::chrono::steady_clock::time_point updated;
+
+    private:
+
+        DataStormContract::StringSeq update(std::set<std::string>&, char, const DataStormContract::StringSeq&, bool);
+    };
+
+    void resync(const std::shared_ptr<DataStormContract::LookupPrx>&);
+    void requestResync(const std::shared_ptr<DataStormContract::NodePrx>&, const std::shared_ptr<Ice::Connection>&);
+
+    void legacyPeer(const std::shared_ptr<DataStormContract::LookupPrx>&,
+                    const std::shared_ptr<Ice::Connection>&) const;
+    void announceLegacyTopics(const DataStormContract::StringSeq&,
+                              const DataStormContract::StringSeq&,
+                              const std::shared_ptr<DataStormContract::NodePrx>&) const;
+
+    void removeConnection(const std::shared_ptr<Ice::Connection>&);
+    void expirePeerTopics();
+
     void connect(const std::shared_ptr<DataStormContract::LookupPrx>&,
                  const std::shared_ptr<DataStormContract::NodePrx>&);
 
@@ -62,6 +126,12 @@ private:
 
     void destroySession(const std::shared_ptr<DataStormContract::NodePrx>&);
 
+    DataStormContract::StringSeq filterRelayTopics(const DataStormContract::StringSeq&) const;
+    long long int filterRelayDigest(const TopicNames&, long long int) const;
+    DataStormContract::TopicNamesDelta getForwardedFullDelta(const TopicNames&) const;
+
+    std::shared_ptr<DataStormContract::NodePrx> getPublicNode(const std::shared_ptr<DataStormContract::NodePrx>&) const;
+
     std::shared_ptr<Instance> getInstance() const
     {
         auto instance = _instance.lock();
@@ -73,15 +143,25 @@ private:
     const std::shared_ptr<TraceLevels> _traceLevels;
     const std::shared_ptr<DataStormContract::NodePrx> _nodePrx;
     const bool _forwardToMulticast;
+    const std::set<std::string> _relayTopics;
 
     mutable std::mutex _mutex;
 
     int _retryCount;
 
+    TopicNames _topics;
+    std::map<Ice::Identity, TopicNames> _peerTopics;
+
     std::map<Ice::Identity, std::shared_ptr<NodeSessionI>> _sessions;
     std::map<Ice::Identity, std::pair<std::shared_ptr<DataStormContract::NodePrx>,
                                       std::shared_ptr<DataStormContract::LookupPrx>>> _connectedTo;
 
+    //
+    // The lookups of the peers which don't support the topic names deltas, the topic names are announced to
+    // these peers with announceTopics.
+    //
+    mutable std::map<std::shared_ptr<Ice::Connection>, std::shared_ptr<DataStormContract::LookupPrx>> _legacyLookups;
+
     mutable std::shared_ptr<Ice::Connection> _exclude;
     std::shared_ptr<DataStormContract::LookupPrx> _forwarder;
 };
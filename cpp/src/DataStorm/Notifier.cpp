@@ -0,0 +1,111 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/Notifier.h>
+
+#include <Ice/Ice.h>
+
+#ifdef _WIN32
+#   include <windows.h>
+#else
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   ifdef __linux__
+#       include <sys/eventfd.h>
+#   endif
+#endif
+
+using namespace std;
+using namespace DataStormI;
+
+Notifier::Notifier()
+{
+#if defined(_WIN32)
+    _event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if(!_event)
+    {
+        throw Ice::SyscallException(__FILE__, __LINE__, static_cast<int>(GetLastError()));
+    }
+#elif defined(__linux__)
+    _fds[0] = _fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_fds[0] < 0)
+    {
+        throw Ice::SyscallException(__FILE__, __LINE__, errno);
+    }
+#else
+    if(pipe(_fds) != 0)
+    {
+        throw Ice::SyscallException(__FILE__, __LINE__, errno);
+    }
+    for(auto fd : _fds)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+}
+
+Notifier::~Notifier()
+{
+#if defined(_WIN32)
+    CloseHandle(_event);
+#else
+    close(_fds[0]);
+    if(_fds[1] != _fds[0])
+    {
+        close(_fds[1]);
+    }
+#endif
+}
+
+DataStorm::NotificationHandle
+Notifier::getHandle() const
+{
+#ifdef _WIN32
+    return _event;
+#else
+    return _fds[0];
+#endif
+}
+
+void
+Notifier::signal()
+{
+#if defined(_WIN32)
+    SetEvent(_event);
+#elif defined(__linux__)
+    uint64_t value = 1;
+    while(write(_fds[1], &value, sizeof(value)) < 0 && errno == EINTR)
+    {
+    }
+#else
+    char value = 0;
+    while(write(_fds[1], &value, sizeof(value)) < 0 && errno == EINTR)
+    {
+    }
+#endif
+}
+
+void
+Notifier::reset()
+{
+#if defined(_WIN32)
+    ResetEvent(_event);
+#else
+    char buffer[64];
+    while(true)
+    {
+        auto count = read(_fds[0], buffer, sizeof(buffer));
+        if(count > 0 && static_cast<size_t>(count) == sizeof(buffer))
+        {
+            continue; // The pipe might not be empty
+        }
+        else if(count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        break;
+    }
+#endif
+}
@@ -0,0 +1,38 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/Config.h>
+#include <DataStorm/Types.h>
+
+namespace DataStormI
+{
+
+//
+// A notifier provides a handle which can be polled by an application event loop, an eventfd on Linux, a pipe on
+// other POSIX platforms and a manual-reset event on Windows. The handle is readable once signaled and until it's
+// reset.
+//
+class Notifier
+{
+public:
+
+    Notifier();
+    ~Notifier();
+
+    DataStorm::NotificationHandle getHandle() const;
+
+    void signal();
+    void reset();
+
+private:
+
+#ifdef _WIN32
+    void* _event;
+#else
+    int _fds[2];
+#endif
+};
+
+}
@@ -0,0 +1,144 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/PublishExecutor.h>
+#include <DataStorm/DataElementI.h>
+
+using namespace std;
+using namespace DataStormI;
+
+PublishQueue::PublishQueue() : _head(new Node()), _size(0)
+{
+    _head.load()->next.store(nullptr, memory_order_relaxed);
+    _tail = _head.load();
+}
+
+PublishQueue::~PublishQueue()
+{
+    auto node = _tail;
+    while(node)
+    {
+        auto next = node->next.load();
+        delete node;
+        node = next;
+    }
+}
+
+bool
+PublishQueue::push(Item item)
+{
+    auto node = new Node();
+    node->next.store(nullptr, memory_order_relaxed);
+    node->item = move(item);
+    auto previous = _head.exchange(node, memory_order_acq_rel);
+    previous->next.store(node, memory_order_release);
+
+    // Returns true if the queue was empty, the caller has to schedule the consumer.
+    return _size.fetch_add(1, memory_order_acq_rel) == 0;
+}
+
+bool
+PublishQueue::consume(const function<void(Item&)>& consumer, size_t max)
+{
+    auto count = min(_size.load(memory_order_acquire), max);
+    for(size_t i = 0; i < count; ++i)
+    {
+        //
+        // The item is counted but the producer might not have linked its node yet, in which case we wait for
+        // the producer to complete the push.
+        //
+        Node* next;
+        while(!(next = _tail->next.load(memory_order_acquire)))
+        {
+            this_thread::yield();
+        }
+        delete _tail;
+        _tail = next;
+        auto item = move(next->item);
+        consumer(item);
+    }
+
+    // Returns true if items were pushed while consuming, the caller has to schedule the consumer again.
+    return _size.fetch_sub(count, memory_order_acq_rel) != count;
+}
+
+const size_t PublishExecutor::batchSize;
+
+PublishExecutor::PublishExecutor(int threadCount) : _destroyed(false)
+{
+    for(int i = 0; i < max(threadCount, 1); ++i)
+    {
+        _threads.emplace_back(&PublishExecutor::run, this);
+    }
+}
+
+void
+PublishExecutor::queue(const shared_ptr<DataWriterI>& writer)
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        if(!_destroyed)
+        {
+            _queue.push_back(writer);
+            _cond.notify_one();
+            return;
+        }
+    }
+    writer->discardQueued();
+}
+
+void
+PublishExecutor::destroy()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _destroyed = true;
+        _cond.notify_all();
+    }
+    for(auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+
+    //
+    // The sender threads are joined, the samples of the writers still queued are discarded. This completes the
+    // pending flushes.
+    //
+    for(const auto& writer : _queue)
+    {
+        writer->discardQueued();
+    }
+    _queue.clear();
+}
+
+void
+PublishExecutor::run()
+{
+    while(true)
+    {
+        shared_ptr<DataWriterI> writer;
+        {
+            unique_lock<mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return _destroyed || !_queue.empty(); });
+            if(_destroyed)
+            {
+                return;
+            }
+            writer = move(_queue.front());
+            _queue.pop_front();
+        }
+
+        //
+        // Publish a batch of samples and queue the writer again if it has more samples to publish, this
+        // ensures writers publishing continuously don't starve the other writers. The samples which fail to
+        // be published are traced and dropped by the writer, publishQueued doesn't raise.
+        //
+        if(writer->publishQueued(batchSize))
+        {
+            lock_guard<mutex> lock(_mutex);
+            _queue.push_back(move(writer)); // Discarded by destroy if the executor is destroyed
+            _cond.notify_one();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/Config.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DataStormI
+{
+
+class DataWriterI;
+class Key;
+class Sample;
+
+//
+// The queue of the samples published by an asynchronous writer. Producers push the samples without locking,
+// the samples are consumed by a single sender thread at a time: the producer which pushes the first sample of
+// an empty queue schedules the writer with the publish executor and the sender thread which consumes the
+// samples schedules the writer again if new samples were pushed in the meantime.
+//
+class PublishQueue
+{
+public:
+
+    struct Item
+    {
+        std::shared_ptr<Key> key;
+        std::shared_ptr<Sample> sample;
+        std::function<void()> flushed;
+    };
+
+    PublishQueue();
+    ~PublishQueue();
+
+    bool push(Item);
+    bool consume(const std::function<void(Item&)>&, size_t);
+
+private:
+
+    struct Node
+    {
+        std::atomic<Node*> next;
+        Item item;
+    };
+
+    std::atomic<Node*> _head;
+    Node* _tail;
+    std::atomic<size_t> _size;
+};
+
+//
+// The publish executor runs the sender threads which publish the samples queued by asynchronous writers.
+//
+class PublishExecutor
+{
+public:
+
+    PublishExecutor(int);
+
+    void queue(const std::shared_ptr<DataWriterI>&);
+    void destroy();
+
+private:
+
+    void run();
+
+    static const size_t batchSize = 64;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _destroyed;
+    std::deque<std::shared_ptr<DataWriterI>> _queue;
+    std::vector<std::thread> _threads;
+};
+
+}
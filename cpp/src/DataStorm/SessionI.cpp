@@ -16,8 +16,11 @@
 #include <DataStorm/TopicFactoryI.h>
 #include <DataStorm/TraceUtil.h>
 #include <DataStorm/CallbackExecutor.h>
+#include <DataStorm/FlightRecorder.h>
 #include <DataStorm/Timer.h>
 
+#include <limits>
+
 using namespace std;
 using namespace DataStormI;
 using namespace DataStormContract;
@@ -47,16 +50,68 @@ private:
     shared_ptr<CallbackExecutor> _executor;
 };
 
+//
+// The handshake requests for several topics are sent in batches which don't exceed half of Ice.MessageSizeMax.
+// The topic entries are marshaled to compute their size, a topic entry larger than the batch size is sent alone.
+//
+size_t
+getMaxBatchSize(const shared_ptr<Instance>& instance)
+{
+    auto messageSizeMax = instance->getCommunicator()->getProperties()->getPropertyAsIntWithDefault(
+        "Ice.MessageSizeMax", 1024);
+    if(messageSizeMax < 1)
+    {
+        return numeric_limits<size_t>::max();
+    }
+    return static_cast<size_t>(messageSizeMax) * 1024 / 2;
+}
+
+template<typename T, typename F> void
+sendBatches(const shared_ptr<Ice::Communicator>& communicator, size_t maxSize, vector<T>& seq, F send)
+{
+    if(maxSize == numeric_limits<size_t>::max())
+    {
+        send(seq);
+        return;
+    }
+
+    vector<T> batch;
+    size_t size = 0;
+    for(auto& v : seq)
+    {
+        Ice::OutputStream stream(communicator);
+        stream.write(v);
+        if(!batch.empty() && size + stream.b.size() > maxSize)
+        {
+            send(batch);
+            batch.clear();
+            size = 0;
+        }
+        size += stream.b.size();
+        batch.push_back(move(v));
+    }
+    if(!batch.empty())
+    {
+        send(batch);
+    }
+}
+
 }
 
 SessionI::SessionI(const std::shared_ptr<NodeI>& parent, const shared_ptr<NodePrx>& node) :
     _instance(parent->getInstance()),
     _traceLevels(_instance->getTraceLevels()),
+    _maxBatchSize(getMaxBatchSize(_instance)),
     _parent(parent),
     _node(node),
     _destroyed(false),
     _sessionInstanceId(0),
-    _retryCount(0)
+    _retryCount(0),
+    _retryTimer(0),
+    _sent(0),
+    _bytesOut(0),
+    _received(0),
+    _bytesIn(0)
 {
 }
 
@@ -105,6 +160,7 @@ SessionI::announceTopics(TopicInfoSeq topics, bool initialize, const Ice::Curren
             out << _id << ": announcing topics `" << topics << "'";
         }
 
+        TopicSpecSeq specs;
         for(const auto& info : topics)
         {
             runWithTopics(info.name, retained, [&](const shared_ptr<TopicI>& topic)
@@ -113,9 +169,14 @@ SessionI::announceTopics(TopicInfoSeq topics, bool initialize, const Ice::Curren
                 {
                     topic->attach(id, shared_from_this(), _session);
                 }
-                _session->attachTopicAsync(topic->getTopicSpec());
+                specs.push_back(topic->getTopicSpec());
             });
         }
+        if(!specs.empty())
+        {
+            sendBatches(_instance->getCommunicator(), _maxBatchSize, specs,
+                        [this](const TopicSpecSeq& batch) { _session->attachTopicsAsync(batch); });
+        }
 
         // Reap un-visited topics
         auto p = _topics.begin();
@@ -135,6 +196,12 @@ SessionI::announceTopics(TopicInfoSeq topics, bool initialize, const Ice::Curren
 
 void
 SessionI::attachTopic(TopicSpec spec, const Ice::Current& current)
+{
+    attachTopics({ move(spec) }, current);
+}
+
+void
+SessionI::attachTopics(TopicSpecSeq specs, const Ice::Current&)
 {
     //
     // Retain topics outside the synchronization. This is necessary to ensure the topic destructor
@@ -149,42 +216,48 @@ SessionI::attachTopic(TopicSpec spec, const Ice::Current& current)
             return;
         }
 
-        runWithTopics(spec.name, retained, [&](const shared_ptr<TopicI>& topic)
+        TopicElementSpecsSeq topics;
+        for(const auto& spec : specs)
         {
-            if(_traceLevels->session > 2)
+            runWithTopics(spec.name, retained, [&](const shared_ptr<TopicI>& topic)
             {
-                Trace out(_traceLevels, _traceLevels->sessionCat);
-                out << _id << ": attaching topic `" << spec << "' to `" << topic << "'";
-            }
+                if(_traceLevels->session > 2)
+                {
+                    Trace out(_traceLevels, _traceLevels->sessionCat);
+                    out << _id << ": attaching topic `" << spec << "' to `" << topic << "'";
+                }
 
-            topic->attach(spec.id, shared_from_this(), _session);
+                topic->attach(spec.id, shared_from_this(), _session);
 
-            if(!spec.tags.empty())
-            {
-                auto& subscriber = _topics.at(spec.id).getSubscriber(topic.get());
-                for(const auto& tag : spec.tags)
+                if(!spec.tags.empty())
                 {
-                    subscriber.tags[tag.id] = topic->getTagFactory()->decode(_instance->getCommunicator(), tag.value);
+                    auto& subscriber = _topics.at(spec.id).getSubscriber(topic.get());
+                    for(const auto& tag : spec.tags)
+                    {
+                        subscriber.tags[tag.id] = topic->getTagFactory()->decode(_instance->getCommunicator(),
+                                                                                 tag.value);
+                    }
                 }
-            }
 
-            auto tags = topic->getTags();
-            if(!tags.empty())
-            {
-                _session->attachTagsAsync(topic->getId(), tags, true);
-            }
-
-            auto specs = topic->getElementSpecs(spec.id, spec.elements, shared_from_this());
-            if(!specs.empty())
-            {
-                if(_traceLevels->session > 2)
+                auto tags = topic->getTags();
+                auto elements = topic->getElementSpecs(spec.id, spec.elements, shared_from_this());
+                if(!elements.empty() && _traceLevels->session > 2)
                 {
                     Trace out(_traceLevels, _traceLevels->sessionCat);
                     out << _id << ": matched elements `" << spec << "' on `" << topic << "'";
                 }
-                _session->attachElementsAsync(topic->getId(), specs, true);
-            }
-        });
+                if(!tags.empty() || !elements.empty())
+                {
+                    topics.push_back({ topic->getId(), move(tags), move(elements) });
+                }
+            });
+        }
+
+        if(!topics.empty())
+        {
+            sendBatches(_instance->getCommunicator(), _maxBatchSize, topics,
+                        [this](const TopicElementSpecsSeq& batch) { _session->attachTopicsElementsAsync(batch); });
+        }
     }
 }
 
@@ -219,24 +292,7 @@ SessionI::attachTags(long long int topicId, ElementInfoSeq tags, bool initialize
     {
         return;
     }
-
-    runWithTopics(topicId, [&](TopicI* topic, TopicSubscriber& subscriber, TopicSubscribers& subscribers)
-    {
-        if(_traceLevels->session > 2)
-        {
-            Trace out(_traceLevels, _traceLevels->sessionCat);
-            out << _id << ": attaching tags `[" << tags << "]@" << topicId << "' on topic `" << topic << "'";
-        }
-
-        if(initialize)
-        {
-            subscriber.tags.clear();
-        }
-        for(const auto& tag : tags)
-        {
-            subscriber.tags[tag.id] = topic->getTagFactory()->decode(_instance->getCommunicator(), tag.value);
-        }
-    });
+    attachTagsImpl(topicId, tags, initialize);
 }
 
 void
@@ -302,7 +358,189 @@ SessionI::attachElements(long long int id, ElementSpecSeq elements, bool initial
         return;
     }
 
+    TopicElementSpecAcksSeq acks;
+    attachElementsImpl(id, elements, initialize, chrono::system_clock::now(), acks);
+    for(const auto& ack : acks)
+    {
+        _session->attachElementsAckAsync(ack.topic, ack.elements);
+    }
+}
+
+void
+SessionI::attachElementsAck(long long int id, ElementSpecAckSeq elements, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+
+    TopicDataSamplesSeq samples;
+    attachElementsAckImpl(id, elements, chrono::system_clock::now(), samples);
+    for(const auto& s : samples)
+    {
+        _session->initSamplesAsync(s.topic, s.samples);
+    }
+}
+
+void
+SessionI::detachElements(long long int id, LongSeq elements, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+
+    runWithTopics(id, [&](TopicI* topic, TopicSubscriber& subscriber)
+    {
+        if(_traceLevels->session > 2)
+        {
+            Trace out(_traceLevels, _traceLevels->sessionCat);
+            out << _id << ": detaching elements `[" << elements << "]@" << id << "' on topic `" << topic << "'";
+        }
+
+        for(auto e : elements)
+        {
+            auto k = subscriber.remove(e);
+            for(auto& s : k.getSubscribers())
+            {
+                for(auto key : s.second.keys)
+                {
+                    if(e > 0)
+                    {
+                        s.first->detachKey(id, e, key, shared_from_this(), s.second.facet, true);
+                    }
+                    else
+                    {
+                        s.first->detachFilter(id, -e, key, shared_from_this(), s.second.facet, true);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void
+SessionI::initSamples(long long int topicId, DataSamplesSeq samplesSeq, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+    initSamplesImpl(topicId, samplesSeq, chrono::system_clock::now());
+}
+
+void
+SessionI::attachTopicsElements(TopicElementSpecsSeq topics, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+
+    auto now = chrono::system_clock::now();
+    TopicElementSpecAcksSeq acks;
+    for(const auto& topic : topics)
+    {
+        if(!topic.tags.empty())
+        {
+            attachTagsImpl(topic.topic, topic.tags, true);
+        }
+        if(!topic.elements.empty())
+        {
+            attachElementsImpl(topic.topic, topic.elements, true, now, acks);
+        }
+    }
+
+    if(!acks.empty())
+    {
+        sendBatches(_instance->getCommunicator(), _maxBatchSize, acks,
+                    [this](const TopicElementSpecAcksSeq& batch) { _session->attachTopicsElementsAckAsync(batch); });
+    }
+}
+
+void
+SessionI::attachTopicsElementsAck(TopicElementSpecAcksSeq topics, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+
+    auto now = chrono::system_clock::now();
+    TopicDataSamplesSeq samples;
+    for(const auto& topic : topics)
+    {
+        attachElementsAckImpl(topic.topic, topic.elements, now, samples);
+    }
+
+    if(!samples.empty())
+    {
+        sendBatches(_instance->getCommunicator(), _maxBatchSize, samples,
+                    [this](const TopicDataSamplesSeq& batch) { _session->initTopicsSamplesAsync(batch); });
+    }
+}
+
+void
+SessionI::initTopicsSamples(TopicDataSamplesSeq topics, const Ice::Current&)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session)
+    {
+        return;
+    }
+
     auto now = chrono::system_clock::now();
+    for(const auto& topic : topics)
+    {
+        initSamplesImpl(topic.topic, topic.samples, now);
+    }
+}
+
+void
+SessionI::samplesReceived(const DataSampleSeq& samples)
+{
+    // Called with _mutex locked
+    _received += static_cast<long long int>(samples.size());
+    for(const auto& sample : samples)
+    {
+        _bytesIn += static_cast<long long int>(sample.value.size());
+    }
+}
+
+void
+SessionI::attachTagsImpl(long long int topicId, const ElementInfoSeq& tags, bool initialize)
+{
+    runWithTopics(topicId, [&](TopicI* topic, TopicSubscriber& subscriber, TopicSubscribers& subscribers)
+    {
+        if(_traceLevels->session > 2)
+        {
+            Trace out(_traceLevels, _traceLevels->sessionCat);
+            out << _id << ": attaching tags `[" << tags << "]@" << topicId << "' on topic `" << topic << "'";
+        }
+
+        if(initialize)
+        {
+            subscriber.tags.clear();
+        }
+        for(const auto& tag : tags)
+        {
+            subscriber.tags[tag.id] = topic->getTagFactory()->decode(_instance->getCommunicator(), tag.value);
+        }
+    });
+}
+
+void
+SessionI::attachElementsImpl(long long int id,
+                             const ElementSpecSeq& elements,
+                             bool initialize,
+                             const chrono::time_point<chrono::system_clock>& now,
+                             TopicElementSpecAcksSeq& acks)
+{
     runWithTopics(id, [&](TopicI* topic, TopicSubscriber& subscriber, TopicSubscribers& subscribers)
     {
         if(_traceLevels->session > 2)
@@ -332,20 +570,17 @@ SessionI::attachElements(long long int id, ElementSpecSeq elements, bool initial
                 Trace out(_traceLevels, _traceLevels->sessionCat);
                 out << _id << ": attaching elements matched `[" << specAck << "]@" << id << "' on topic `" << topic << "'";
             }
-            _session->attachElementsAckAsync(topic->getId(), specAck);
+            acks.push_back({ topic->getId(), move(specAck) });
         }
     });
 }
 
 void
-SessionI::attachElementsAck(long long int id, ElementSpecAckSeq elements, const Ice::Current&)
+SessionI::attachElementsAckImpl(long long int id,
+                                const ElementSpecAckSeq& elements,
+                                const chrono::time_point<chrono::system_clock>& now,
+                                TopicDataSamplesSeq& samplesSeq)
 {
-    lock_guard<mutex> lock(_mutex);
-    if(!_session)
-    {
-        return;
-    }
-    auto now = chrono::system_clock::now();
     runWithTopics(id, [&](TopicI* topic, TopicSubscriber& subscriber, TopicSubscribers& subscribers)
     {
         if(_traceLevels->session > 2)
@@ -363,7 +598,7 @@ SessionI::attachElementsAck(long long int id, ElementSpecAckSeq elements, const
                 Trace out(_traceLevels, _traceLevels->sessionCat);
                 out << _id << ": initializing elements `[" << samples << "]@" << id << "' on topic `" << topic << "'";
             }
-            _session->initSamplesAsync(topic->getId(), samples);
+            samplesSeq.push_back({ topic->getId(), move(samples) });
         }
         if(!removedIds.empty())
         {
@@ -373,56 +608,17 @@ SessionI::attachElementsAck(long long int id, ElementSpecAckSeq elements, const
 }
 
 void
-SessionI::detachElements(long long int id, LongSeq elements, const Ice::Current&)
+SessionI::initSamplesImpl(long long int topicId,
+                          const DataSamplesSeq& samplesSeq,
+                          const chrono::time_point<chrono::system_clock>& now)
 {
-    lock_guard<mutex> lock(_mutex);
-    if(!_session)
-    {
-        return;
-    }
-
-    runWithTopics(id, [&](TopicI* topic, TopicSubscriber& subscriber)
+    for(const auto& samples : samplesSeq)
     {
-        if(_traceLevels->session > 2)
+        samplesReceived(samples.samples);
+        for(const auto& s : samples.samples)
         {
-            Trace out(_traceLevels, _traceLevels->sessionCat);
-            out << _id << ": detaching elements `[" << elements << "]@" << id << "' on topic `" << topic << "'";
+            FlightRecorder::record(FlightEvent::Received, topicId, samples.id, s.id);
         }
-
-        for(auto e : elements)
-        {
-            auto k = subscriber.remove(e);
-            for(auto& s : k.getSubscribers())
-            {
-                for(auto key : s.second.keys)
-                {
-                    if(e > 0)
-                    {
-                        s.first->detachKey(id, e, key, shared_from_this(), s.second.facet, true);
-                    }
-                    else
-                    {
-                        s.first->detachFilter(id, -e, key, shared_from_this(), s.second.facet, true);
-                    }
-                }
-            }
-        }
-    });
-}
-
-void
-SessionI::initSamples(long long int topicId, DataSamplesSeq samplesSeq, const Ice::Current& current)
-{
-    lock_guard<mutex> lock(_mutex);
-    if(!_session)
-    {
-        return;
-    }
-
-    auto now = chrono::system_clock::now();
-    auto communicator = _instance->getCommunicator();
-    for(const auto& samples : samplesSeq)
-    {
         runWithTopics(topicId, [&](TopicI* topic, TopicSubscriber& subscriber)
         {
             auto k = subscriber.get(samples.id);
@@ -476,12 +672,15 @@ SessionI::initSamples(long long int topicId, DataSamplesSeq samplesSeq, const Ic
                 {
                     if(!ks.second.initialized)
                     {
-                        ks.second.initialized = true;
                         if(!samplesI.empty())
                         {
                             ks.second.lastId = samplesI.back()->id;
                             ks.first->initSamples(samplesI, topicId, samples.id, k->priority, now, samples.id < 0);
                         }
+                        for(const auto& p : ks.second.initialize())
+                        {
+                            ks.first->queue(p.sample, k->priority, shared_from_this(), p.facet, now, p.checkKey);
+                        }
                     }
                 }
             }
@@ -504,7 +703,8 @@ SessionI::disconnected(const Ice::Current& current)
 void
 SessionI::connected(const shared_ptr<SessionPrx>& session,
                     const shared_ptr<Ice::Connection>& connection,
-                    const TopicInfoSeq& topics)
+                    const TopicInfoSeq& topics,
+                    const shared_ptr<SessionPrx>& laneSession)
 {
     lock_guard<mutex> lock(_mutex);
     if(_destroyed || _session)
@@ -515,6 +715,19 @@ SessionI::connected(const shared_ptr<SessionPrx>& session,
 
     _session = session;
     _connection = connection;
+    if(laneSession && (!laneSession->ice_getEndpoints().empty() || !laneSession->ice_getAdapterId().empty()))
+    {
+        {
+            lock_guard<mutex> laneLock(_laneMutex);
+            _laneSession = laneSession;
+        }
+
+        // Establish the lane connections before the writers attach to the peer readers
+        for(auto lane : _parent->getLanes())
+        {
+            getLaneProxy(lane);
+        }
+    }
     if(connection)
     {
         auto self = shared_from_this();
@@ -532,10 +745,10 @@ SessionI::connected(const shared_ptr<SessionPrx>& session,
                                                });
     }
 
-    if(_retryCanceller)
+    if(_retryTimer)
     {
-        _retryCanceller();
-        _retryCanceller = nullptr;
+        _instance->getTimer()->cancel(_retryTimer);
+        _retryTimer = 0;
     }
 
     ++_sessionInstanceId;
@@ -611,6 +824,7 @@ SessionI::disconnected(const shared_ptr<Ice::Connection>& connection, exception_
     _session = nullptr;
     _connection = nullptr;
     _retryCount = 0;
+    clearLanes();
     return true;
 }
 
@@ -643,10 +857,10 @@ SessionI::retry(const shared_ptr<NodePrx>& node, exception_ptr exception)
 
     if(node->ice_getEndpoints().empty() && node->ice_getAdapterId().empty())
     {
-        if(_retryCanceller)
+        if(_retryTimer)
         {
-            _retryCanceller();
-            _retryCanceller = nullptr;
+            _instance->getTimer()->cancel(_retryTimer);
+            _retryTimer = 0;
         }
         _retryCount = 0;
 
@@ -664,7 +878,7 @@ SessionI::retry(const shared_ptr<NodePrx>& node, exception_ptr exception)
                 << " (ms) for peer to reconnect";
         }
 
-        _retryCanceller = _instance->getTimer()->schedule(delay, [=, self = shared_from_this()] {
+        _retryTimer = _instance->getTimer()->schedule(delay, [=, self = shared_from_this()] {
             remove();
         });
     }
@@ -707,11 +921,11 @@ SessionI::retry(const shared_ptr<NodePrx>& node, exception_ptr exception)
             return false;
         }
 
-        _retryCanceller = _instance->getTimer()->schedule(delay,
-                                                          [=, self=shared_from_this()]
-                                                          {
-                                                              reconnect(node);
-                                                          });
+        _retryTimer = _instance->getTimer()->schedule(delay,
+                                                      [=, self=shared_from_this()]
+                                                      {
+                                                          reconnect(node);
+                                                      });
     }
     return true;
 }
@@ -757,6 +971,7 @@ SessionI::destroyImpl(const exception_ptr& ex)
 
         _session = nullptr;
         _connection = nullptr;
+        clearLanes();
 
         for(const auto& t : _topics)
         {
@@ -790,6 +1005,49 @@ SessionI::getConnection() const
     return _connection;
 }
 
+void
+SessionI::sampleSent(size_t size)
+{
+    ++_sent;
+    _bytesOut += static_cast<long long int>(size);
+}
+
+DataStorm::SessionDescription
+SessionI::describe() const
+{
+    lock_guard<mutex> lock(_mutex);
+    DataStorm::SessionDescription description;
+    description.id = _id;
+    description.publisher = false;
+    description.node = _node ? _node->ice_toString() : string();
+    description.connection = _connection ? _connection->toString() : string();
+    set<string> topics;
+    for(const auto& t : _topics)
+    {
+        for(const auto& s : t.second.getSubscribers())
+        {
+            topics.insert(s.first->getName());
+        }
+    }
+    description.topics.assign(topics.begin(), topics.end());
+    return description;
+}
+
+DataStorm::SessionMetrics
+SessionI::getMetrics() const
+{
+    lock_guard<mutex> lock(_mutex);
+    DataStorm::SessionMetrics metrics;
+    metrics.id = _id;
+    metrics.publisher = false;
+    metrics.connection = _connection ? _connection->toString() : string();
+    metrics.sent = _sent;
+    metrics.received = _received;
+    metrics.bytesOut = _bytesOut;
+    metrics.bytesIn = _bytesIn;
+    return metrics;
+}
+
 bool
 SessionI::checkSession()
 {
@@ -837,6 +1095,51 @@ SessionI::getSession() const
     return _session;
 }
 
+shared_ptr<SessionPrx>
+SessionI::getLaneProxy(int lane)
+{
+    // Called by the data writers with the topic mutex locked and on connection with the session mutex locked
+    shared_ptr<SessionPrx> proxy;
+    {
+        lock_guard<mutex> lock(_laneMutex);
+        auto p = _lanes.find(lane);
+        if(p != _lanes.end())
+        {
+            return p->second.connection ? p->second.proxy : nullptr;
+        }
+        else if(!_laneSession)
+        {
+            return nullptr;
+        }
+
+        // The connection ID ensures the lane gets its own connection
+        proxy = _laneSession->ice_connectionId("ds.lane." + to_string(lane));
+        _lanes.emplace(lane, Lane { proxy, nullptr });
+    }
+
+    //
+    // The samples are sent over the session connection until the lane connection is established and attached to
+    // the peer session.
+    //
+    auto self = shared_from_this();
+    try
+    {
+        proxy->ice_getConnectionAsync([self, lane, proxy](auto connection)
+                                      {
+                                          self->laneConnected(lane, proxy, connection, nullptr);
+                                      },
+                                      [self, lane, proxy](auto ex)
+                                      {
+                                          self->laneConnected(lane, proxy, nullptr, ex);
+                                      });
+    }
+    catch(const Ice::LocalException&)
+    {
+        laneConnected(lane, proxy, nullptr, current_exception());
+    }
+    return nullptr;
+}
+
 shared_ptr<NodePrx>
 SessionI::getNode() const
 {
@@ -1063,7 +1366,8 @@ SessionI::subscriberInitialized(long long int topicId,
                                 long long int elementId,
                                 const DataSampleSeq& samples,
                                 const shared_ptr<Key>& key,
-                                const std::shared_ptr<DataElementI>& element)
+                                const std::shared_ptr<DataElementI>& element,
+                                vector<PendingSample>& pending)
 {
     assert(_topics.find(topicId) != _topics.end());
     auto& subscriber = _topics.at(topicId).getSubscriber(element->getTopic());
@@ -1076,8 +1380,8 @@ SessionI::subscriberInitialized(long long int topicId,
         Trace out(_traceLevels, _traceLevels->sessionCat);
         out << _id << ": initialized `" << element << "' from `e" << elementId << '@' << topicId << "'";
     }
-    s->initialized = true;
     s->lastId = samples.empty() ? 0 : samples.back().id;
+    pending = s->initialize();
 
     vector<shared_ptr<Sample>> samplesI;
     samplesI.reserve(samples.size());
@@ -1185,6 +1489,121 @@ SessionI::runWithTopic(long long int id, TopicI* topic, function<void (TopicSubs
     }
 }
 
+void
+SessionI::laneConnected(int lane,
+                        const shared_ptr<SessionPrx>& proxy,
+                        const shared_ptr<Ice::Connection>& connection,
+                        exception_ptr ex)
+{
+    if(!connection)
+    {
+        laneAttached(lane, proxy, nullptr, ex);
+        return;
+    }
+
+    //
+    // The peer session only accepts the samples received over the lane connection once it's attached, the lane
+    // is used once the peer acknowledged the attach.
+    //
+    auto self = shared_from_this();
+    try
+    {
+        Ice::uncheckedCast<SubscriberSessionPrx>(proxy->ice_fixed(connection))->attachLaneAsync(
+            lane,
+            [self, lane, proxy, connection]()
+            {
+                self->laneAttached(lane, proxy, connection, nullptr);
+            },
+            [self, lane, proxy](auto ex)
+            {
+                self->laneAttached(lane, proxy, nullptr, ex);
+            });
+    }
+    catch(const Ice::LocalException&)
+    {
+        laneAttached(lane, proxy, nullptr, current_exception());
+    }
+}
+
+void
+SessionI::laneAttached(int lane,
+                       const shared_ptr<SessionPrx>& proxy,
+                       const shared_ptr<Ice::Connection>& connection,
+                       exception_ptr ex)
+{
+    lock_guard<mutex> lock(_laneMutex);
+    auto p = _lanes.find(lane);
+    if(p == _lanes.end() || p->second.proxy != proxy)
+    {
+        return; // The session was disconnected
+    }
+
+    if(!connection)
+    {
+        //
+        // The lane samples are sent over the session connection until the session reconnects, a lane which
+        // can't be established (or which isn't supported by the peer) isn't retried for each sample.
+        //
+        if(_traceLevels->session > 0)
+        {
+            Trace out(_traceLevels, _traceLevels->sessionCat);
+            out << _id << ": couldn't establish connection for lane " << lane;
+            try
+            {
+                rethrow_exception(ex);
+            }
+            catch(const std::exception& e)
+            {
+                out << ":\n" << e.what();
+            }
+        }
+        return;
+    }
+
+    p->second.proxy = proxy->ice_fixed(connection);
+    p->second.connection = connection;
+    auto self = shared_from_this();
+    _instance->getConnectionManager()->add(self, connection, [self, lane](auto connection, auto)
+                                           {
+                                               self->laneDisconnected(lane, connection);
+                                           });
+
+    if(_traceLevels->session > 0)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << _id << ": lane " << lane << " connected\n" << connection->toString();
+    }
+}
+
+void
+SessionI::laneDisconnected(int lane, const shared_ptr<Ice::Connection>& connection)
+{
+    // The lane is established again for the next sample.
+    lock_guard<mutex> lock(_laneMutex);
+    auto p = _lanes.find(lane);
+    if(p != _lanes.end() && p->second.connection == connection)
+    {
+        _lanes.erase(p);
+    }
+}
+
+void
+SessionI::clearLanes()
+{
+    // Called with the session mutex locked
+    lock_guard<mutex> lock(_laneMutex);
+    for(const auto& lane : _lanes)
+    {
+        if(lane.second.connection)
+        {
+            _instance->getConnectionManager()->remove(shared_from_this(), lane.second.connection);
+        }
+    }
+    _lanes.clear();
+    _laneSession = nullptr;
+    _peerLaneConnections.clear();
+}
+
 SubscriberSessionI::SubscriberSessionI(const std::shared_ptr<NodeI>& parent, const shared_ptr<NodePrx>& node) :
     SessionI(parent, node)
 {
@@ -1200,7 +1619,10 @@ void
 SubscriberSessionI::s(long long int topicId, long long int elementId, DataSample s, const Ice::Current& current)
 {
     lock_guard<mutex> lock(_mutex);
-    if(!_session || current.con != _connection)
+    // The samples of writers with a lane are received over a lane connection attached by the peer session.
+    bool fromLane = current.con != _connection &&
+        _peerLaneConnections.find(current.con) != _peerLaneConnections.end();
+    if(!_session || (current.con != _connection && !fromLane))
     {
         if(current.con != _connection)
         {
@@ -1217,6 +1639,9 @@ SubscriberSessionI::s(long long int topicId, long long int elementId, DataSample
         }
         return;
     }
+    ++_received;
+    _bytesIn += static_cast<long long int>(s.value.size());
+    FlightRecorder::record(FlightEvent::Received, topicId, elementId, s.id);
     auto now = chrono::system_clock::now();
     runWithTopics(topicId, [&](TopicI* topic, TopicSubscriber& subscriber, TopicSubscribers& topicSubscribers)
     {
@@ -1269,16 +1694,51 @@ SubscriberSessionI::s(long long int topicId, long long int elementId, DataSample
                                                           s.timestamp);
             for(auto& es : e->getSubscribers())
             {
-                if(es.second.initialized && (s.keyId <= 0 || es.second.keys.find(key) != es.second.keys.end()))
+                if(s.keyId > 0 && es.second.keys.find(key) == es.second.keys.end())
+                {
+                    continue;
+                }
+                else if(!es.second.initialized)
+                {
+                    es.second.pending.push_back({ impl, current.facet, !s.keyValue.empty() });
+                }
+                else if(s.id > es.second.initLastId)
                 {
                     es.second.lastId = s.id;
                     es.first->queue(impl, e->priority, shared_from_this(), current.facet, now, !s.keyValue.empty());
                 }
+                else if(_traceLevels->session > 2)
+                {
+                    // The sample was already received with the initialization samples
+                    Trace out(_traceLevels, _traceLevels->sessionCat);
+                    out << _id << ": skipped duplicate sample `" << s.id << "' for `" << es.first << "'";
+                }
             }
         }
     });
 }
 
+void
+SubscriberSessionI::attachLane(int lane, const Ice::Current& current)
+{
+    //
+    // The lane can be attached before this session is connected, the publisher session is connected first. The
+    // lane connections are cleared when the session is disconnected.
+    //
+    lock_guard<mutex> lock(_mutex);
+    if(_destroyed || !current.con)
+    {
+        return;
+    }
+    _peerLaneConnections.insert(current.con);
+
+    if(_traceLevels->session > 0)
+    {
+        Trace out(_traceLevels, _traceLevels->sessionCat);
+        out << _id << ": attached lane " << lane << "\n" << current.con->toString();
+    }
+}
+
 void
 SubscriberSessionI::reconnect(const shared_ptr<NodePrx>& node)
 {
@@ -1301,6 +1761,31 @@ PublisherSessionI::PublisherSessionI(const std::shared_ptr<NodeI>& parent, const
 {
 }
 
+void
+PublisherSessionI::credit(long long int topicId,
+                          long long int elementId,
+                          long long int lastId,
+                          int credit,
+                          const Ice::Current& current)
+{
+    lock_guard<mutex> lock(_mutex);
+    if(!_session || current.con != _connection)
+    {
+        return;
+    }
+    runWithTopics(topicId, [&](TopicI*, TopicSubscriber& subscriber)
+    {
+        auto e = subscriber.get(elementId);
+        if(e)
+        {
+            for(auto& es : e->getSubscribers())
+            {
+                es.first->credit(shared_from_this(), es.second.facet, lastId, credit);
+            }
+        }
+    });
+}
+
 vector<shared_ptr<TopicI>>
 PublisherSessionI::getTopics(const string& name) const
 {
@@ -5,9 +5,12 @@
 
 #include <DataStorm/NodeI.h>
 #include <DataStorm/Contract.h>
+#include <DataStorm/Timer.h>
 
 #include <Ice/Ice.h>
 
+#include <atomic>
+
 namespace DataStormI
 {
 
@@ -20,21 +23,63 @@ class TraceLevels;
 
 class SessionI : virtual public DataStormContract::Session, public std::enable_shared_from_this<SessionI>
 {
+public:
+
+    //
+    // A sample received before the subscriber is initialized. The samples sent by a writer can be received before
+    // the samples that initialize the subscriber (if the writer uses a lane connection or if the publication raced
+    // with the attach), they are queued once the subscriber is initialized.
+    //
+    struct PendingSample
+    {
+        std::shared_ptr<Sample> sample;
+        std::string facet;
+        bool checkKey;
+    };
+
 protected:
 
     struct ElementSubscriber
     {
         ElementSubscriber(const std::string& facet, const std::shared_ptr<Key>& key, int sessionInstanceId) :
-            facet(facet), initialized(false), lastId(0), sessionInstanceId(sessionInstanceId)
+            facet(facet), initialized(false), lastId(0), initLastId(0), sessionInstanceId(sessionInstanceId)
         {
             keys.insert(key);
         }
 
+        std::vector<PendingSample> initialize()
+        {
+            //
+            // Called once the initialization samples are received, returns the pending samples which weren't
+            // already received with the initialization samples.
+            //
+            initialized = true;
+            initLastId = lastId;
+            std::vector<PendingSample> samples;
+            for(auto& p : pending)
+            {
+                if(p.sample->id > initLastId)
+                {
+                    lastId = p.sample->id;
+                    samples.push_back(std::move(p));
+                }
+            }
+            pending.clear();
+            return samples;
+        }
+
         const std::string facet;
         bool initialized;
         long long int lastId;
+
+        //
+        // The id of the last sample received with the initialization samples. Samples sent with a lower or equal id
+        // are duplicates, samples with a greater id can be received out of order if they were conflated.
+        //
+        long long int initLastId;
         std::set<std::shared_ptr<Key>> keys;
         int sessionInstanceId;
+        std::vector<PendingSample> pending;
     };
 
     class ElementSubscribers
@@ -233,6 +278,12 @@ protected:
             return _subscribers;
         }
 
+        const std::map<TopicI*, TopicSubscriber>&
+        getSubscribers() const
+        {
+            return _subscribers;
+        }
+
         bool
         reap(int sessionInstanceId)
         {
@@ -281,11 +332,17 @@ public:
 
     virtual void initSamples(long long int, DataStormContract::DataSamplesSeq, const Ice::Current&) override;
 
+    virtual void attachTopics(DataStormContract::TopicSpecSeq, const Ice::Current&) override;
+    virtual void attachTopicsElements(DataStormContract::TopicElementSpecsSeq, const Ice::Current&) override;
+    virtual void attachTopicsElementsAck(DataStormContract::TopicElementSpecAcksSeq, const Ice::Current&) override;
+    virtual void initTopicsSamples(DataStormContract::TopicDataSamplesSeq, const Ice::Current&) override;
+
     virtual void disconnected(const Ice::Current&) override;
 
     void connected(const std::shared_ptr<DataStormContract::SessionPrx>&,
                    const std::shared_ptr<Ice::Connection>&,
-                   const DataStormContract::TopicInfoSeq&);
+                   const DataStormContract::TopicInfoSeq&,
+                   const std::shared_ptr<DataStormContract::SessionPrx>& = nullptr);
     bool disconnected(const std::shared_ptr<Ice::Connection>&, std::exception_ptr);
     bool retry(const std::shared_ptr<DataStormContract::NodePrx>&, std::exception_ptr);
     void destroyImpl(const std::exception_ptr&);
@@ -297,6 +354,7 @@ public:
 
     std::shared_ptr<Ice::Connection> getConnection() const;
     std::shared_ptr<DataStormContract::SessionPrx> getSession() const;
+    std::shared_ptr<DataStormContract::SessionPrx> getLaneProxy(int);
     bool checkSession();
 
     template<typename T = DataStormContract::SessionPrx> std::shared_ptr<T> getProxy() const
@@ -326,27 +384,51 @@ public:
     void unsubscribeFromFilter(long long int, long long int, const std::shared_ptr<DataElementI>&, long long int);
     void disconnectFromFilter(long long int, long long int, const std::shared_ptr<DataElementI>&, long long int);
 
+    void sampleSent(size_t);
+    DataStorm::SessionMetrics getMetrics() const;
+    DataStorm::SessionDescription describe() const;
+
     DataStormContract::LongLongDict getLastIds(long long int, long long int, const std::shared_ptr<DataElementI>&);
     std::vector<std::shared_ptr<Sample>> subscriberInitialized(long long int,
                                                                long long int,
                                                                const DataStormContract::DataSampleSeq&,
                                                                const std::shared_ptr<Key>&,
-                                                               const std::shared_ptr<DataElementI>&);
+                                                               const std::shared_ptr<DataElementI>&,
+                                                               std::vector<PendingSample>&);
 
 protected:
 
+    void attachTagsImpl(long long int, const DataStormContract::ElementInfoSeq&, bool);
+    void attachElementsImpl(long long int, const DataStormContract::ElementSpecSeq&, bool,
+                            const std::chrono::time_point<std::chrono::system_clock>&,
+                            DataStormContract::TopicElementSpecAcksSeq&);
+    void attachElementsAckImpl(long long int, const DataStormContract::ElementSpecAckSeq&,
+                               const std::chrono::time_point<std::chrono::system_clock>&,
+                               DataStormContract::TopicDataSamplesSeq&);
+    void initSamplesImpl(long long int, const DataStormContract::DataSamplesSeq&,
+                         const std::chrono::time_point<std::chrono::system_clock>&);
+    void samplesReceived(const DataStormContract::DataSampleSeq&);
+
     void runWithTopics(const std::string&, std::vector<std::shared_ptr<TopicI>>&,
                        std::function<void (const std::shared_ptr<TopicI>&)>);
     void runWithTopics(long long int, std::function<void (TopicI*, TopicSubscriber&)>);
     void runWithTopics(long long int, std::function<void (TopicI*, TopicSubscriber&, TopicSubscribers&)>);
     void runWithTopic(long long int, TopicI*, std::function<void (TopicSubscriber&)>);
 
+    void laneConnected(int, const std::shared_ptr<DataStormContract::SessionPrx>&,
+                       const std::shared_ptr<Ice::Connection>&, std::exception_ptr);
+    void laneAttached(int, const std::shared_ptr<DataStormContract::SessionPrx>&,
+                      const std::shared_ptr<Ice::Connection>&, std::exception_ptr);
+    void laneDisconnected(int, const std::shared_ptr<Ice::Connection>&);
+    void clearLanes();
+
     virtual std::vector<std::shared_ptr<TopicI>> getTopics(const std::string&) const = 0;
     virtual void reconnect(const std::shared_ptr<DataStormContract::NodePrx>&) = 0;
     virtual void remove() = 0;
 
     const std::shared_ptr<Instance> _instance;
     std::shared_ptr<TraceLevels> _traceLevels;
+    const size_t _maxBatchSize;
     mutable std::mutex _mutex;
     std::shared_ptr<NodeI> _parent;
     std::string _id;
@@ -355,7 +437,7 @@ protected:
     bool _destroyed;
     int _sessionInstanceId;
     int _retryCount;
-    std::function<void()> _retryCanceller;
+    Timer::TimerId _retryTimer;
 
     std::map<long long int, TopicSubscribers> _topics;
     std::unique_lock<std::mutex>* _topicLock;
@@ -363,6 +445,34 @@ protected:
     std::shared_ptr<DataStormContract::SessionPrx> _session;
     std::shared_ptr<Ice::Connection> _connection;
     std::vector<std::function<void(std::shared_ptr<DataStormContract::SessionPrx>)>> _connectedCallbacks;
+
+    struct Lane
+    {
+        std::shared_ptr<DataStormContract::SessionPrx> proxy;
+        std::shared_ptr<Ice::Connection> connection;
+    };
+
+    //
+    // The lane connections are used by the data writers with the topic mutex locked, they are protected by the
+    // lane mutex which is locked after the session and topic mutexes. The lane session is the peer session proxy
+    // without a fixed connection, it's only set for publisher sessions with a peer which has endpoints.
+    //
+    std::mutex _laneMutex;
+    std::shared_ptr<DataStormContract::SessionPrx> _laneSession;
+    std::map<int, Lane> _lanes;
+
+    //
+    // The lane connections attached by the peer publisher session, protected by the session mutex.
+    //
+    std::set<std::shared_ptr<Ice::Connection>> _peerLaneConnections;
+
+    //
+    // The sent counters are updated by the data writers with the topic mutex locked, not the session mutex.
+    //
+    std::atomic<long long int> _sent;
+    std::atomic<long long int> _bytesOut;
+    long long int _received;
+    long long int _bytesIn;
 };
 
 class SubscriberSessionI : public SessionI, public DataStormContract::SubscriberSession
@@ -372,6 +482,7 @@ public:
     SubscriberSessionI(const std::shared_ptr<NodeI>&, const std::shared_ptr<DataStormContract::NodePrx>&);
 
     virtual void s(long long int, long long int, DataStormContract::DataSample, const Ice::Current&) override;
+    virtual void attachLane(int, const Ice::Current&) override;
 
 private:
 
@@ -386,6 +497,8 @@ public:
 
     PublisherSessionI(const std::shared_ptr<NodeI>&, const std::shared_ptr<DataStormContract::NodePrx>&);
 
+    virtual void credit(long long int, long long int, long long int, int, const Ice::Current&) override;
+
 private:
 
     virtual std::vector<std::shared_ptr<TopicI>> getTopics(const std::string&) const override;
@@ -1,8 +1,10 @@
 //
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
+#include <algorithm>
 #include <vector>
 #include <iostream>
+#include <limits>
 #include <assert.h>
 
 #include <DataStorm/Timer.h>
@@ -10,40 +12,117 @@
 using namespace std;
 using namespace DataStormI;
 
+namespace
+{
+
+const uint64_t never = numeric_limits<uint64_t>::max();
+
+}
+
+const int Timer::levelBits;
+const int Timer::levelCount;
+const uint32_t Timer::slotCount;
+const uint32_t Timer::none;
+
 Timer::Timer() :
-    _destroyed(false)
+    _destroyed(false),
+    _start(chrono::steady_clock::now()),
+    _current(0),
+    _wakeup(never),
+    _size(0),
+    _free(none)
 {
+    fill(begin(_slots), end(_slots), none);
     _thread = thread(&Timer::runTimer, this);
 }
 
-function<void()>
+Timer::TimerId
 Timer::schedule(chrono::milliseconds duration, function<void()> callback)
 {
     lock_guard<mutex> lock(_mutex);
     if(_destroyed)
     {
-        return []{};
+        return 0;
+    }
+
+    uint32_t index;
+    if(_free != none)
+    {
+        index = _free;
+        _free = _entries[index].next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(_entries.size());
+        _entries.push_back({ 0, nullptr, 1, none, none, none });
+    }
+
+    auto now = chrono::steady_clock::now();
+    if(_size == 0)
+    {
+        // The wheel is empty, move it to the current time: the timer thread might not have advanced it for a while.
+        _current = max(_current, toTick(now, false));
     }
-    auto scheduledAt = chrono::steady_clock::now() + duration;
-    auto it = _timers.emplace(scheduledAt, callback);
-    _cond.notify_one();
-    return [=, self=shared_from_this()]() {
+
+    auto& entry = _entries[index];
+    entry.expiration = max(toTick(now + duration, true), _current + 1);
+    entry.callback = move(callback);
+    insert(index);
+    ++_size;
+
+    if(entry.expiration < _wakeup)
+    {
+        _wakeup = entry.expiration;
+        _cond.notify_one();
+    }
+    return (static_cast<uint64_t>(entry.generation) << 32) | index;
+}
+
+bool
+Timer::cancel(TimerId id)
+{
+    function<void()> callback;
+    {
         lock_guard<mutex> lock(_mutex);
-        if(!_destroyed && scheduledAt > chrono::steady_clock::now())
+        auto index = static_cast<uint32_t>(id);
+        if(_destroyed ||
+           index >= _entries.size() ||
+           _entries[index].generation != static_cast<uint32_t>(id >> 32) ||
+           _entries[index].slot == none)
         {
-            _timers.erase(it);
+            return false; // Already fired or canceled.
         }
-    };
+
+        // The callback is destroyed once the mutex is released, it might hold the last reference of its owner.
+        callback = move(_entries[index].callback);
+        unlink(index);
+        release(index);
+        --_size;
+    }
+    return true;
+}
+
+size_t
+Timer::getSize() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _size;
 }
 
 void
 Timer::destroy()
 {
-    unique_lock<mutex> lock(_mutex);
-    _destroyed = true;
-    _timers.clear(); // TODO: Notify the timers instead?
-    _cond.notify_one();
-    lock.unlock();
+    vector<Entry> entries;
+    {
+        unique_lock<mutex> lock(_mutex);
+        _destroyed = true;
+        entries = move(_entries); // The callbacks are destroyed once the mutex is released.
+        _entries.clear();
+        fill(begin(_slots), end(_slots), none);
+        _free = none;
+        _size = 0;
+        _cond.notify_one();
+    }
     _thread.join();
 }
 
@@ -55,53 +134,201 @@ Timer::runTimer()
     {
         {
             unique_lock<mutex> lock(_mutex);
-            if(_destroyed)
+            while(true)
             {
-                return;
-            }
+                if(_destroyed)
+                {
+                    return;
+                }
 
-            if(_timers.empty())
-            {
-                _cond.wait(lock, [this] { return !_timers.empty() || _destroyed; });
-            }
-            else
-            {
-                auto waitUntil = _timers.cbegin()->first;
-                _cond.wait_until(lock,
-                                 waitUntil,
-                                 [=] { return _destroyed ||
-                                              _timers.empty() ||
-                                              _timers.cbegin()->first <= chrono::steady_clock::now(); });
-                if(_timers.empty())
+                advance(toTick(chrono::steady_clock::now(), false), tasks);
+                if(!tasks.empty())
                 {
-                    continue; // A task has been canceled or the timer is destroyed.
+                    _wakeup = 0; // Timers scheduled while the tasks run are checked once they complete.
+                    break;
                 }
 
-                auto now = chrono::steady_clock::now();
-                auto p = _timers.begin();
-                for(; p != _timers.end() && p->first <= now; ++p)
+                _wakeup = nextExpiration();
+                if(_wakeup == never)
+                {
+                    _cond.wait(lock);
+                }
+                else
                 {
-                    tasks.push_back(move(p->second));
+                    _cond.wait_until(lock, _start + chrono::milliseconds(_wakeup));
                 }
-                _timers.erase(_timers.begin(), p);
             }
         }
-        if(!tasks.empty())
+
+        for(auto& t : tasks)
         {
-            for(auto& t : tasks)
+            try
             {
-                try
-                {
-                    t();
-                }
-                catch(const std::exception& ex)
-                {
-                    cerr << ex.what() << endl;
-                    assert(false);
-                    throw;
-                }
+                t();
+            }
+            catch(const std::exception& ex)
+            {
+                cerr << ex.what() << endl;
+                assert(false);
+                throw;
             }
         }
         tasks.clear();
     }
 }
+
+void
+Timer::insert(uint32_t index)
+{
+    auto& entry = _entries[index];
+    auto expiration = entry.expiration;
+    auto delta = expiration > _current ? expiration - _current : 0;
+
+    int level = 0;
+    while(level < levelCount - 1 && delta >= (uint64_t(1) << (levelBits * (level + 1))))
+    {
+        ++level;
+    }
+
+    //
+    // Timers beyond the range of the wheel are stored in the last slot of the upper level, they are inserted
+    // again with their real expiration when cascaded.
+    //
+    if(delta >= (uint64_t(1) << (levelBits * levelCount)))
+    {
+        expiration = _current + (uint64_t(1) << (levelBits * levelCount)) - 1;
+    }
+
+    auto slot = static_cast<uint32_t>(level) * slotCount +
+        static_cast<uint32_t>((expiration >> (levelBits * level)) & (slotCount - 1));
+    entry.slot = slot;
+    entry.previous = none;
+    entry.next = _slots[slot];
+    if(entry.next != none)
+    {
+        _entries[entry.next].previous = index;
+    }
+    _slots[slot] = index;
+}
+
+void
+Timer::unlink(uint32_t index)
+{
+    auto& entry = _entries[index];
+    if(entry.previous != none)
+    {
+        _entries[entry.previous].next = entry.next;
+    }
+    else
+    {
+        _slots[entry.slot] = entry.next;
+    }
+    if(entry.next != none)
+    {
+        _entries[entry.next].previous = entry.previous;
+    }
+    entry.slot = none;
+}
+
+void
+Timer::release(uint32_t index)
+{
+    auto& entry = _entries[index];
+    entry.callback = nullptr;
+    if(++entry.generation == 0)
+    {
+        entry.generation = 1;
+    }
+    entry.next = _free;
+    _free = index;
+}
+
+void
+Timer::cascade(int level)
+{
+    auto slot = static_cast<uint32_t>(level) * slotCount +
+        static_cast<uint32_t>((_current >> (levelBits * level)) & (slotCount - 1));
+    auto index = _slots[slot];
+    _slots[slot] = none;
+    while(index != none)
+    {
+        auto next = _entries[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void
+Timer::advance(uint64_t now, vector<function<void()>>& tasks)
+{
+    while(_current < now)
+    {
+        if(_size == 0)
+        {
+            _current = now;
+            return;
+        }
+
+        ++_current;
+
+        //
+        // Cascade the timers of the upper levels when the lower level wraps around.
+        //
+        for(int level = 1; level < levelCount && (_current & ((uint64_t(1) << (levelBits * level)) - 1)) == 0;
+            ++level)
+        {
+            cascade(level);
+        }
+
+        auto index = _slots[_current & (slotCount - 1)];
+        while(index != none)
+        {
+            auto next = _entries[index].next;
+            assert(_entries[index].expiration <= _current);
+            tasks.push_back(move(_entries[index].callback));
+            unlink(index);
+            release(index);
+            --_size;
+            index = next;
+        }
+    }
+}
+
+uint64_t
+Timer::nextExpiration() const
+{
+    if(_size == 0)
+    {
+        return never;
+    }
+
+    //
+    // Look for the next non-empty slot of the lower level until it wraps around, the thread has to wake up when
+    // it wraps around to cascade the upper level timers.
+    //
+    auto wrap = (_current | (slotCount - 1)) + 1;
+    for(auto tick = _current + 1; tick < wrap; ++tick)
+    {
+        if(_slots[tick & (slotCount - 1)] != none)
+        {
+            return tick;
+        }
+    }
+    return wrap;
+}
+
+uint64_t
+Timer::toTick(chrono::steady_clock::time_point time, bool roundUp) const
+{
+    if(time <= _start)
+    {
+        return 0;
+    }
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(time - _start);
+    auto tick = static_cast<uint64_t>(elapsed.count() / 1000000);
+    if(roundUp && elapsed.count() % 1000000 != 0)
+    {
+        ++tick;
+    }
+    return tick;
+}
@@ -7,33 +7,75 @@
 
 #include <memory>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <thread>
-#include <map>
+#include <vector>
 #include <condition_variable>
 #include <mutex>
 
 namespace DataStormI
 {
 
+//
+// Hierarchical timing wheel with a resolution of one millisecond. The wheel has 4 levels of 256 slots, each
+// level covering 256 times the range of the previous level. Timers are stored in a pool and linked in the slot
+// of their expiration time, scheduling and canceling a timer is O(1). Timers of the upper levels are cascaded
+// to the lower levels when the lower level wraps around.
+//
 class Timer : public std::enable_shared_from_this<Timer>
 {
 public:
 
+    //
+    // The identifier of a scheduled timer, 0 is never a valid identifier.
+    //
+    using TimerId = std::uint64_t;
+
     Timer();
 
-    std::function<void()> schedule(std::chrono::milliseconds, std::function<void()>);
+    TimerId schedule(std::chrono::milliseconds, std::function<void()>);
+    bool cancel(TimerId);
+    size_t getSize() const;
     void destroy();
 
 private:
 
+    static const int levelBits = 8;
+    static const int levelCount = 4;
+    static const std::uint32_t slotCount = 1 << levelBits;
+    static const std::uint32_t none = 0xFFFFFFFF;
+
+    struct Entry
+    {
+        std::uint64_t expiration;
+        std::function<void()> callback;
+        std::uint32_t generation;
+        std::uint32_t slot;
+        std::uint32_t previous;
+        std::uint32_t next;
+    };
+
     void runTimer();
+    void insert(std::uint32_t);
+    void unlink(std::uint32_t);
+    void release(std::uint32_t);
+    void cascade(int);
+    void advance(std::uint64_t, std::vector<std::function<void()>>&);
+    std::uint64_t nextExpiration() const;
+    std::uint64_t toTick(std::chrono::steady_clock::time_point, bool) const;
 
     std::thread _thread;
     mutable std::mutex _mutex;
     std::condition_variable _cond;
     bool _destroyed;
-    std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> _timers;
+    const std::chrono::steady_clock::time_point _start;
+    std::uint64_t _current;
+    std::uint64_t _wakeup;
+    size_t _size;
+    std::vector<Entry> _entries;
+    std::uint32_t _free;
+    std::uint32_t _slots[levelCount * slotCount];
 };
 
 }
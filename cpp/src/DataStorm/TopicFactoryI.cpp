@@ -40,12 +40,18 @@ TopicFactoryI::createTopicReader(const string& name,
                                            name,
                                            _nextReaderId++);
         reader->init();
-        _readers[name].push_back(reader);
+        auto& readers = _readers[name];
+        bool newName = readers.empty();
+        readers.push_back(reader);
         if(_traceLevels->topic > 0)
         {
             Trace out(_traceLevels, _traceLevels->topicCat);
             out << name << ": created topic reader";
         }
+        if(newName)
+        {
+            announceTopicsDelta({ name }, {}, {}, {});
+        }
 
         hasWriters = _writers.find(name) != _writers.end();
     }
@@ -60,7 +66,6 @@ TopicFactoryI::createTopicReader(const string& name,
             node->createSubscriberSession(nodePrx, nullptr, nullptr);
         }
         node->getSubscriberForwarder()->announceTopics({ { name, { reader->getId() } } }, false);
-        instance->getNodeSessionManager()->announceTopicReader(name, nodePrx);
     }
     catch(const Ice::CommunicatorDestroyedException&)
     {
@@ -96,12 +101,18 @@ TopicFactoryI::createTopicWriter(const string& name,
                                            name,
                                            _nextWriterId++);
         writer->init();
-        _writers[name].push_back(writer);
+        auto& writers = _writers[name];
+        bool newName = writers.empty();
+        writers.push_back(writer);
         if(_traceLevels->topic > 0)
         {
             Trace out(_traceLevels, _traceLevels->topicCat);
             out << name << ": created topic writer";
         }
+        if(newName)
+        {
+            announceTopicsDelta({}, { name }, {}, {});
+        }
 
         hasReaders = _readers.find(name) != _readers.end();
     }
@@ -116,7 +127,6 @@ TopicFactoryI::createTopicWriter(const string& name,
             node->createPublisherSession(nodePrx, nullptr, nullptr);
         }
         node->getPublisherForwarder()->announceTopics({ { name, { writer->getId() } } }, false);
-        instance->getNodeSessionManager()->announceTopicWriter(name, nodePrx);
     }
     catch(const Ice::CommunicatorDestroyedException&)
     {
@@ -146,6 +156,7 @@ TopicFactoryI::removeTopicReader(const string& name, const shared_ptr<TopicI>& r
     if(readers.empty())
     {
         _readers.erase(name);
+        announceTopicsDelta({}, {}, { name }, {});
     }
 }
 
@@ -163,6 +174,7 @@ TopicFactoryI::removeTopicWriter(const string& name, const shared_ptr<TopicI>& w
     if(writers.empty())
     {
         _writers.erase(name);
+        announceTopicsDelta({}, {}, {}, { name });
     }
 }
 
@@ -280,6 +292,62 @@ TopicFactoryI::getTopicWriterNames() const
     return writers;
 }
 
+DataStorm::TopicMetricsSeq
+TopicFactoryI::getMetrics() const
+{
+    vector<shared_ptr<TopicI>> readers;
+    vector<shared_ptr<TopicI>> writers;
+    getTopics(readers, writers);
+
+    DataStorm::TopicMetricsSeq metrics;
+    metrics.reserve(readers.size() + writers.size());
+    for(const auto& reader : readers)
+    {
+        metrics.push_back(reader->getMetrics());
+        metrics.back().reader = true;
+    }
+    for(const auto& writer : writers)
+    {
+        metrics.push_back(writer->getMetrics());
+    }
+    return metrics;
+}
+
+DataStorm::TopicDescriptionSeq
+TopicFactoryI::describe() const
+{
+    vector<shared_ptr<TopicI>> readers;
+    vector<shared_ptr<TopicI>> writers;
+    getTopics(readers, writers);
+
+    DataStorm::TopicDescriptionSeq descriptions;
+    descriptions.reserve(readers.size() + writers.size());
+    for(const auto& reader : readers)
+    {
+        descriptions.push_back(reader->describe());
+        descriptions.back().reader = true;
+    }
+    for(const auto& writer : writers)
+    {
+        descriptions.push_back(writer->describe());
+    }
+    return descriptions;
+}
+
+void
+TopicFactoryI::getTopics(vector<shared_ptr<TopicI>>& readers, vector<shared_ptr<TopicI>>& writers) const
+{
+    lock_guard<mutex> lock(_mutex);
+    for(const auto& p : _readers)
+    {
+        readers.insert(readers.end(), p.second.begin(), p.second.end());
+    }
+    for(const auto& p : _writers)
+    {
+        writers.insert(writers.end(), p.second.begin(), p.second.end());
+    }
+}
+
 void
 TopicFactoryI::shutdown() const
 {
@@ -305,3 +373,33 @@ TopicFactoryI::getCommunicator() const
 {
     return getInstance()->getCommunicator();
 }
+
+void
+TopicFactoryI::announceTopicsDelta(const DataStormContract::StringSeq& addedReaders,
+                                   const DataStormContract::StringSeq& addedWriters,
+                                   const DataStormContract::StringSeq& removedReaders,
+                                   const DataStormContract::StringSeq& removedWriters) const
+{
+    //
+    // Called with _mutex locked: the node session manager must apply the deltas in the same order as the topic
+    // name changes. Otherwise, a concurrent removal and creation of a topic with the same name could be applied
+    // in the wrong order and the topic would no longer be announced.
+    //
+    try
+    {
+        auto instance = _instance.lock();
+        if(instance)
+        {
+            instance->getNodeSessionManager()->announceTopicsDelta(addedReaders,
+                                                                   addedWriters,
+                                                                   removedReaders,
+                                                                   removedWriters);
+        }
+    }
+    catch(const Ice::CommunicatorDestroyedException&)
+    {
+    }
+    catch(const Ice::ObjectAdapterDeactivatedException&)
+    {
+    }
+}
@@ -5,6 +5,8 @@
 
 #include <DataStorm/InternalI.h>
 #include <DataStorm/Contract.h>
+#include <DataStorm/Admin.h>
+#include <DataStorm/Metrics.h>
 
 namespace DataStormI
 {
@@ -64,10 +66,20 @@ public:
     DataStormContract::StringSeq getTopicReaderNames() const;
     DataStormContract::StringSeq getTopicWriterNames() const;
 
+    DataStorm::TopicMetricsSeq getMetrics() const;
+    DataStorm::TopicDescriptionSeq describe() const;
+
     void shutdown() const;
 
 private:
 
+    void getTopics(std::vector<std::shared_ptr<TopicI>>&, std::vector<std::shared_ptr<TopicI>>&) const;
+
+    void announceTopicsDelta(const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&,
+                             const DataStormContract::StringSeq&) const;
+
     mutable std::mutex _mutex;
     std::weak_ptr<Instance> _instance;
     std::shared_ptr<TraceLevels> _traceLevels;
@@ -41,6 +41,44 @@ static Topic::Updater noOpUpdater = [](const shared_ptr<Sample>& previous,
     next->setValue(previous);
 };
 
+Topic::Updater
+makeCompositeUpdater(shared_ptr<const map<shared_ptr<Tag>, Topic::Updater>> updaters,
+                     shared_ptr<TagFactory> tagFactory,
+                     shared_ptr<SampleFactory> sampleFactory)
+{
+    //
+    // A composite partial update sample has no tag, its value is the sequence of the encoded tags and values of
+    // its partial updates. The partial updates are applied in order, each to the value computed by the previous
+    // one. The updaters are a copy of the topic updaters, the composite updater is called with or without the
+    // topic mutex locked.
+    //
+    return [updaters, tagFactory, sampleFactory](const shared_ptr<Sample>& previous,
+                                                 const shared_ptr<Sample>& next,
+                                                 const shared_ptr<Ice::Communicator>& communicator)
+    {
+        vector<vector<unsigned char>> updates;
+        Ice::InputStream(communicator, next->getEncodedValue()).read(updates);
+        auto timestamp = chrono::duration_cast<chrono::microseconds>(next->timestamp.time_since_epoch()).count();
+        auto value = previous;
+        for(size_t i = 0; i + 1 < updates.size(); i += 2)
+        {
+            auto tag = tagFactory->decode(communicator, updates[i]);
+            auto update = sampleFactory->create(next->session,
+                                                next->origin,
+                                                next->id,
+                                                DataStorm::SampleEvent::PartialUpdate,
+                                                next->key,
+                                                tag,
+                                                move(updates[i + 1]),
+                                                timestamp);
+            auto p = updaters->find(tag);
+            (p != updaters->end() ? p->second : noOpUpdater)(value, update, communicator);
+            value = update;
+        }
+        next->setValue(value);
+    };
+}
+
 // The always match filter always matches the value, it's used by the any key reader/writer.
 class AlwaysMatchFilter : public Filter
 {
@@ -102,6 +140,7 @@ TopicI::TopicI(const weak_ptr<TopicFactoryI>& factory,
     _nextFilteredId(0),
     _nextSampleId(0)
 {
+    _compositeUpdater = makeCompositeUpdater(make_shared<map<shared_ptr<Tag>, Updater>>(), _tagFactory, _sampleFactory);
 }
 
 TopicI::~TopicI()
@@ -112,8 +151,7 @@ TopicI::~TopicI()
 void
 TopicI::init()
 {
-    auto forwarder = [self=shared_from_this()](Ice::ByteSeq e, const Ice::Current& c) { self->forward(e, c); };
-    _forwarder = Ice::uncheckedCast<SessionPrx>(_instance->getCollocatedForwarder()->add(forwarder));
+    _forwarder = Ice::uncheckedCast<SessionPrx>(_instance->getCollocatedForwarder()->add(shared_from_this()));
 }
 
 string
@@ -151,6 +189,21 @@ TopicI::shutdown()
 {
     lock_guard<mutex> lock(_mutex);
     _cond.notify_all();
+
+    // Complete the asynchronous waits of the elements with NodeShutdownException
+    set<shared_ptr<DataElementI>> elements;
+    for(const auto& p : _keyElements)
+    {
+        elements.insert(p.second.begin(), p.second.end());
+    }
+    for(const auto& p : _filteredElements)
+    {
+        elements.insert(p.second.begin(), p.second.end());
+    }
+    for(const auto& element : elements)
+    {
+        element->shutdown();
+    }
 }
 
 TopicSpec
@@ -172,6 +225,77 @@ TopicI::getTopicSpec() const
     return spec;
 }
 
+DataStorm::TopicMetrics
+TopicI::getMetrics() const
+{
+    lock_guard<mutex> lock(_mutex);
+    DataStorm::TopicMetrics metrics;
+    metrics.name = _name;
+    metrics.reader = false;
+    metrics.published = _counters.published;
+    metrics.queued = _counters.queued;
+    metrics.discardedSendTime = _counters.discardedSendTime;
+    metrics.discardedPriority = _counters.discardedPriority;
+    metrics.discardedFlowControl = _counters.discardedFlowControl;
+    metrics.discardedSlowConsumer = _counters.discardedSlowConsumer;
+    metrics.slowConsumers = _counters.slowConsumers;
+    metrics.filtered = _counters.filtered;
+    metrics.historyDepth = 0;
+    metrics.listenerCount = static_cast<int>(_listenerCount);
+
+    for(const auto& element : getElements())
+    {
+        metrics.elements.push_back(element->getMetrics());
+        metrics.historyDepth += metrics.elements.back().historyDepth;
+    }
+    return metrics;
+}
+
+DataStorm::TopicDescription
+TopicI::describe() const
+{
+    lock_guard<mutex> lock(_mutex);
+    DataStorm::TopicDescription description;
+    description.id = _id;
+    description.name = _name;
+    description.reader = false;
+    description.listenerCount = static_cast<int>(_listenerCount);
+    for(const auto& element : getElements())
+    {
+        description.elements.push_back(element->describe());
+    }
+    return description;
+}
+
+vector<shared_ptr<DataElementI>>
+TopicI::getElements() const
+{
+    // Called with _mutex locked. Multi-key elements are registered with each of their keys.
+    set<shared_ptr<DataElementI>> seen;
+    vector<shared_ptr<DataElementI>> elements;
+    for(const auto& k : _keyElements)
+    {
+        for(const auto& e : k.second)
+        {
+            if(seen.insert(e).second)
+            {
+                elements.push_back(e);
+            }
+        }
+    }
+    for(const auto& f : _filteredElements)
+    {
+        for(const auto& e : f.second)
+        {
+            if(seen.insert(e).second)
+            {
+                elements.push_back(e);
+            }
+        }
+    }
+    return elements;
+}
+
 ElementInfoSeq
 TopicI::getTags() const
 {
@@ -574,6 +698,9 @@ TopicI::setUpdater(const shared_ptr<Tag>& tag, Updater updater)
     if(updater)
     {
         _updaters[tag] = updater;
+        _compositeUpdater = makeCompositeUpdater(make_shared<map<shared_ptr<Tag>, Updater>>(_updaters),
+                                                 _tagFactory,
+                                                 _sampleFactory);
         try
         {
             _forwarder->attachTags(_id, { { tag->getId(), "", tag->encode(_instance->getCommunicator()) } }, false);
@@ -586,6 +713,9 @@ TopicI::setUpdater(const shared_ptr<Tag>& tag, Updater updater)
     else
     {
         _updaters.erase(tag);
+        _compositeUpdater = makeCompositeUpdater(make_shared<map<shared_ptr<Tag>, Updater>>(_updaters),
+                                                 _tagFactory,
+                                                 _sampleFactory);
         try
         {
             _forwarder->detachTags(_id, { tag->getId() });
@@ -601,6 +731,10 @@ const Topic::Updater&
 TopicI::getUpdater(const shared_ptr<Tag>& tag) const
 {
     // Called with mutex locked
+    if(!tag)
+    {
+        return _compositeUpdater;
+    }
     auto p = _updaters.find(tag);
     if(p != _updaters.end())
     {
@@ -614,6 +748,9 @@ TopicI::setUpdaters(map<shared_ptr<Tag>, Updater> updaters)
 {
     unique_lock<mutex> lock(_mutex);
     _updaters = move(updaters);
+    _compositeUpdater = makeCompositeUpdater(make_shared<map<shared_ptr<Tag>, Updater>>(_updaters),
+                                             _tagFactory,
+                                             _sampleFactory);
 }
 
 map<shared_ptr<Tag>, Topic::Updater>
@@ -943,6 +1080,27 @@ TopicReaderI::destroy()
     }
 }
 
+DataStorm::LatencyStatistics
+TopicReaderI::getLatencyStatistics() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _latency.getStatistics();
+}
+
+void
+TopicReaderI::resetLatencyStatistics()
+{
+    lock_guard<mutex> lock(_mutex);
+    _latency.reset();
+}
+
+void
+TopicReaderI::recordLatency(chrono::microseconds latency)
+{
+    // Called with _mutex locked by the data readers
+    _latency.record(latency);
+}
+
 DataStorm::ReaderConfig
 TopicReaderI::parseConfig(const string& prefix) const
 {
@@ -960,10 +1118,37 @@ TopicReaderI::parseConfig(const string& prefix) const
         {
             config.discardPolicy = DataStorm::DiscardPolicy::SendTime;
         }
-        else if(p->second == "SendTime")
+        else if(p->second == "Priority")
         {
             config.discardPolicy = DataStorm::DiscardPolicy::Priority;
         }
+        else if(p->second == "KeepLatestPerKey")
+        {
+            config.discardPolicy = DataStorm::DiscardPolicy::KeepLatestPerKey;
+        }
+    }
+    p = properties.find(prefix + ".LatencyStatistics");
+    if(p != properties.end())
+    {
+        config.latencyStatistics = toInt(p->second) > 0;
+    }
+    p = properties.find(prefix + ".MaxUpdateRate");
+    if(p != properties.end())
+    {
+        config.maxUpdateRate = toInt(p->second);
+    }
+    p = properties.find(prefix + ".MaxUnreadSamples");
+    if(p != properties.end())
+    {
+        config.maxUnreadSamples = toInt(p->second);
+    }
+    p = properties.find(prefix + ".MaxUnreadBytes");
+    if(p != properties.end())
+    {
+        istringstream is(p->second);
+        long long int maxUnreadBytes = 0;
+        is >> maxUnreadBytes;
+        config.maxUnreadBytes = maxUnreadBytes;
     }
     return config;
 }
@@ -987,6 +1172,22 @@ TopicReaderI::mergeConfigs(DataStorm::ReaderConfig config) const
     {
         config.discardPolicy = _defaultConfig.discardPolicy;
     }
+    if(!config.latencyStatistics && _defaultConfig.latencyStatistics)
+    {
+        config.latencyStatistics = _defaultConfig.latencyStatistics;
+    }
+    if(!config.maxUpdateRate && _defaultConfig.maxUpdateRate)
+    {
+        config.maxUpdateRate = _defaultConfig.maxUpdateRate;
+    }
+    if(!config.maxUnreadSamples && _defaultConfig.maxUnreadSamples)
+    {
+        config.maxUnreadSamples = _defaultConfig.maxUnreadSamples;
+    }
+    if(!config.maxUnreadBytes && _defaultConfig.maxUnreadBytes)
+    {
+        config.maxUnreadBytes = _defaultConfig.maxUnreadBytes;
+    }
     return config;
 }
 
@@ -1061,6 +1262,75 @@ TopicWriterI::parseConfig(const string& prefix) const
         is >> priority;
         config.priority = priority;
     }
+    p = properties.find(prefix + ".Async");
+    if(p != properties.end())
+    {
+        istringstream is(p->second);
+        int async;
+        is >> async;
+        config.async = async > 0;
+    }
+    p = properties.find(prefix + ".FlowControlPolicy");
+    if(p != properties.end())
+    {
+        if(p->second == "Drop")
+        {
+            config.flowControlPolicy = DataStorm::FlowControlPolicy::Drop;
+        }
+        else if(p->second == "Block")
+        {
+            config.flowControlPolicy = DataStorm::FlowControlPolicy::Block;
+        }
+    }
+    p = properties.find(prefix + ".MaxBacklogSamples");
+    if(p != properties.end())
+    {
+        config.maxBacklogSamples = toInt(p->second);
+    }
+    p = properties.find(prefix + ".MaxBacklogBytes");
+    if(p != properties.end())
+    {
+        istringstream is(p->second);
+        long long int maxBacklogBytes = 0;
+        is >> maxBacklogBytes;
+        config.maxBacklogBytes = maxBacklogBytes;
+    }
+    p = properties.find(prefix + ".SlowConsumerPolicy");
+    if(p != properties.end())
+    {
+        if(p->second == "Drop")
+        {
+            config.slowConsumerPolicy = DataStorm::SlowConsumerPolicy::Drop;
+        }
+        else if(p->second == "Conflate")
+        {
+            config.slowConsumerPolicy = DataStorm::SlowConsumerPolicy::Conflate;
+        }
+        else if(p->second == "Disconnect")
+        {
+            config.slowConsumerPolicy = DataStorm::SlowConsumerPolicy::Disconnect;
+        }
+    }
+    p = properties.find(prefix + ".Batch");
+    if(p != properties.end())
+    {
+        config.batch = toInt(p->second) > 0;
+    }
+    p = properties.find(prefix + ".BatchSize");
+    if(p != properties.end())
+    {
+        config.batchSize = toInt(p->second);
+    }
+    p = properties.find(prefix + ".BatchFlushInterval");
+    if(p != properties.end())
+    {
+        config.batchFlushInterval = toInt(p->second);
+    }
+    p = properties.find(prefix + ".Lane");
+    if(p != properties.end())
+    {
+        config.lane = toInt(p->second);
+    }
     return config;
 }
 
@@ -1083,5 +1353,41 @@ TopicWriterI::mergeConfigs(DataStorm::WriterConfig config) const
     {
         config.priority = _defaultConfig.priority;
     }
+    if(!config.async && _defaultConfig.async)
+    {
+        config.async = _defaultConfig.async;
+    }
+    if(!config.flowControlPolicy && _defaultConfig.flowControlPolicy)
+    {
+        config.flowControlPolicy = _defaultConfig.flowControlPolicy;
+    }
+    if(!config.maxBacklogSamples && _defaultConfig.maxBacklogSamples)
+    {
+        config.maxBacklogSamples = _defaultConfig.maxBacklogSamples;
+    }
+    if(!config.maxBacklogBytes && _defaultConfig.maxBacklogBytes)
+    {
+        config.maxBacklogBytes = _defaultConfig.maxBacklogBytes;
+    }
+    if(!config.slowConsumerPolicy && _defaultConfig.slowConsumerPolicy)
+    {
+        config.slowConsumerPolicy = _defaultConfig.slowConsumerPolicy;
+    }
+    if(!config.batch && _defaultConfig.batch)
+    {
+        config.batch = _defaultConfig.batch;
+    }
+    if(!config.batchSize && _defaultConfig.batchSize)
+    {
+        config.batchSize = _defaultConfig.batchSize;
+    }
+    if(!config.batchFlushInterval && _defaultConfig.batchFlushInterval)
+    {
+        config.batchFlushInterval = _defaultConfig.batchFlushInterval;
+    }
+    if(!config.lane && _defaultConfig.lane)
+    {
+        config.lane = _defaultConfig.lane;
+    }
     return config;
 }
@@ -7,6 +7,7 @@
 #include <DataStorm/DataElementI.h>
 #include <DataStorm/ForwarderManager.h>
 #include <DataStorm/Instance.h>
+#include <DataStorm/LatencyHistogram.h>
 #include <DataStorm/Types.h>
 
 namespace DataStormI
@@ -15,7 +16,7 @@ namespace DataStormI
 class SessionI;
 class TopicFactoryI;
 
-class TopicI : virtual public Topic, public std::enable_shared_from_this<TopicI>
+class TopicI : virtual public Topic, public Forwarder, public std::enable_shared_from_this<TopicI>
 {
     struct ListenerKey
     {
@@ -131,6 +132,9 @@ public:
     void removeFiltered(const std::shared_ptr<DataElementI>&, const std::shared_ptr<Filter>&);
     void remove(const std::shared_ptr<DataElementI>&, const std::vector<std::shared_ptr<Key>>&);
 
+    DataStorm::TopicMetrics getMetrics() const;
+    DataStorm::TopicDescription describe() const;
+
 protected:
 
     void waitForListeners(int count) const;
@@ -139,13 +143,14 @@ protected:
 
     void disconnect();
 
-    void forward(const Ice::ByteSeq&, const Ice::Current&) const;
+    virtual void forward(const Ice::ByteSeq&, const Ice::Current&) const override;
     void forwarderException() const;
 
     void add(const std::shared_ptr<DataElementI>&, const std::vector<std::shared_ptr<Key>>&);
     void addFiltered(const std::shared_ptr<DataElementI>&, const std::shared_ptr<Filter>&);
 
     void parseConfigImpl(const Ice::PropertyDict&, const std::string&, DataStorm::Config&) const;
+    std::vector<std::shared_ptr<DataElementI>> getElements() const;
 
     friend class DataElementI;
     friend class DataReaderI;
@@ -173,12 +178,14 @@ protected:
     std::map<std::shared_ptr<Filter>, std::set<std::shared_ptr<DataElementI>>> _filteredElements;
     std::map<ListenerKey, Listener> _listeners;
     std::map<std::shared_ptr<Tag>, Updater> _updaters;
+    Updater _compositeUpdater;
     size_t _listenerCount;
     mutable size_t _waiters;
     mutable size_t _notified;
     long long int _nextId;
     long long int _nextFilteredId;
     long long int _nextSampleId;
+    SampleCounters _counters;
 };
 
 class TopicReaderI : public TopicReader, public TopicI
@@ -210,12 +217,18 @@ public:
     virtual bool hasWriters() const override;
     virtual void destroy() override;
 
+    virtual DataStorm::LatencyStatistics getLatencyStatistics() const override;
+    virtual void resetLatencyStatistics() override;
+
+    void recordLatency(std::chrono::microseconds);
+
 private:
 
     DataStorm::ReaderConfig parseConfig(const std::string&) const;
     DataStorm::ReaderConfig mergeConfigs(DataStorm::ReaderConfig) const;
 
     DataStorm::ReaderConfig _defaultConfig;
+    LatencyHistogram _latency;
 };
 
 class TopicWriterI : public TopicWriter, public TopicI
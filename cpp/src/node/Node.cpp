@@ -2,6 +2,7 @@
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
 #include <DataStorm/DataStorm.h>
+#include "Relay.h"
 
 using namespace std;
 
@@ -55,6 +56,12 @@ main(int argc, char* argv[])
             usage(argv[0]);
             return 1;
         }
+
+        //
+        // Relay the topics configured with the DataStorm.Node.Relay.Topics property.
+        //
+        Relay relay(node);
+
         //
         // Shutdown the node on Ctrl-C.
         //
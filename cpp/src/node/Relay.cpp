@@ -0,0 +1,101 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include "Relay.h"
+
+#include <Ice/UUID.h>
+
+using namespace std;
+using namespace DataStorm;
+
+namespace
+{
+
+const string relayPrefix = "DataStorm.Relay/";
+
+}
+
+Relay::Entry::Entry(const Node& node,
+                    const string& topicName,
+                    const string& relayName,
+                    int sampleCount,
+                    int sampleLifetime) :
+    name(topicName),
+    topic(node, topicName),
+    writer(makeAnyKeyWriter(topic, relayName, WriterConfig(sampleCount, sampleLifetime, ClearHistoryPolicy::Never))),
+    reader(makeAnyKeyReader(topic, relayName, ReaderConfig(0))),
+    warnedPartialUpdate(false)
+{
+}
+
+Relay::Relay(const Node& node) :
+    _name(relayPrefix + Ice::generateUUID()),
+    _logger(node.getCommunicator()->getLogger())
+{
+    auto properties = node.getCommunicator()->getProperties();
+    auto topics = properties->getPropertyAsList("DataStorm.Node.Relay.Topics");
+    auto sampleCount = properties->getPropertyAsIntWithDefault("DataStorm.Node.Relay.SampleCount", 1000);
+    auto sampleLifetime = properties->getPropertyAsIntWithDefault("DataStorm.Node.Relay.SampleLifetime", 0);
+
+    if(!topics.empty() && properties->getPropertyAsIntWithDefault("DataStorm.Node.Multicast.Enabled", 1) > 0)
+    {
+        Ice::Warning out(_logger);
+        out << "multicast discovery is enabled, multicast peers of relayed topics might connect to each other ";
+        out << "directly instead of connecting to the relay";
+    }
+
+    for(const auto& name : topics)
+    {
+        _entries.emplace_back(new Entry(node, name, _name, sampleCount, sampleLifetime));
+        auto& entry = *_entries.back();
+        entry.reader.onSamples([this, &entry](const vector<Sample<Opaque, Opaque, Opaque>>& samples)
+                               {
+                                   for(const auto& s : samples)
+                                   {
+                                       relay(entry, s);
+                                   }
+                               },
+                               [this, &entry](const Sample<Opaque, Opaque, Opaque>& sample)
+                               {
+                                   relay(entry, sample);
+                               });
+    }
+}
+
+void
+Relay::relay(Entry& entry, const Sample<Opaque, Opaque, Opaque>& sample)
+{
+    //
+    // Ignore the samples published by relay writers: the relay reader is also connected to the relay writer
+    // and relays don't chain, a topic should only be relayed by a single node.
+    //
+    if(sample.getOrigin().compare(0, relayPrefix.size(), relayPrefix) == 0)
+    {
+        return;
+    }
+
+    switch(sample.getEvent())
+    {
+    case SampleEvent::Add:
+        entry.writer.add(sample.getKey(), sample.getValue());
+        break;
+    case SampleEvent::Update:
+        entry.writer.update(sample.getKey(), sample.getValue());
+        break;
+    case SampleEvent::Remove:
+        entry.writer.remove(sample.getKey());
+        break;
+    case SampleEvent::PartialUpdate:
+        //
+        // Partial updates can't be computed without the topic updaters which are only known by the
+        // applications.
+        //
+        if(!entry.warnedPartialUpdate)
+        {
+            entry.warnedPartialUpdate = true;
+            Ice::Warning out(_logger);
+            out << "relay can't forward partial updates for topic `" << entry.name << "'";
+        }
+        break;
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/DataStorm.h>
+
+//
+// The relay doesn't know the key, value or update tag types of the topics it relays. The Opaque type holds the
+// encoded bytes as-is, the encoder and decoder specializations below just pass the bytes through. Two keys are
+// equal if their encoding is equal.
+//
+struct Opaque
+{
+    std::vector<unsigned char> bytes;
+
+    bool operator<(const Opaque& other) const
+    {
+        return bytes < other.bytes;
+    }
+
+    bool operator==(const Opaque& other) const
+    {
+        return bytes == other.bytes;
+    }
+};
+
+namespace DataStorm
+{
+
+template<> struct Encoder<Opaque>
+{
+    static std::vector<unsigned char>
+    encode(const std::shared_ptr<Ice::Communicator>&, const Opaque& value) noexcept
+    {
+        return value.bytes;
+    }
+};
+
+template<> struct Decoder<Opaque>
+{
+    static Opaque
+    decode(const std::shared_ptr<Ice::Communicator>&, const std::vector<unsigned char>& value) noexcept
+    {
+        return Opaque { value };
+    }
+};
+
+}
+
+//
+// The relay subscribes once to the upstream writers of each relayed topic with an any-key reader and republishes
+// the received samples to the downstream readers with an any-key writer. The writer keeps the configured sample
+// history to serve late joiners. The node doesn't forward the discovery announcements of relayed topics (see the
+// DataStorm.Node.Relay.Topics property) so that readers and writers only connect to the relay.
+//
+// The relay can only hide the peers which discover each other through the node. Nodes which use multicast
+// discovery receive the announcements of the other multicast nodes directly and connect to them without going
+// through the relay: the relayed readers and writers should disable multicast and connect to the relay node with
+// the DataStorm.Node.ConnectTo property.
+//
+class Relay
+{
+public:
+
+    Relay(const DataStorm::Node&);
+
+private:
+
+    using RelayTopic = DataStorm::Topic<Opaque, Opaque, Opaque>;
+
+    struct Entry
+    {
+        Entry(const DataStorm::Node&, const std::string&, const std::string&, int, int);
+
+        const std::string name;
+        RelayTopic topic;
+        DataStorm::MultiKeyWriter<Opaque, Opaque, Opaque> writer;
+        DataStorm::MultiKeyReader<Opaque, Opaque, Opaque> reader;
+        bool warnedPartialUpdate;
+    };
+
+    void relay(Entry&, const DataStorm::Sample<Opaque, Opaque, Opaque>&);
+
+    const std::string _name;
+    const std::shared_ptr<Ice::Logger> _logger;
+    std::vector<std::unique_ptr<Entry>> _entries;
+};
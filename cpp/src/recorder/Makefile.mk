@@ -0,0 +1,9 @@
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+$(project)_programs = dsrecorder
+
+$(project)_targetdir    := $(bindir)
+
+projects += $(project)
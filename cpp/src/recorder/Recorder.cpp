@@ -0,0 +1,211 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/Config.h>
+#include <DataStorm/FlightRecorder.h>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace DataStormI;
+
+namespace
+{
+
+void
+usage(const string& n)
+{
+    cerr << "Usage: " << n << " [options] file\n";
+    cerr <<
+        "Options:\n"
+        "-h, --help               Show this message.\n"
+        "-v, --version            Display the DataStorm version.\n"
+        "--topic=ID               Only show the events of the given topic.\n"
+        "--element=ID             Only show the events of the given data element.\n"
+        "--thread=ID              Only show the events of the given thread.\n"
+        ;
+}
+
+template<typename T> T
+swapBytes(T value)
+{
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    reverse(bytes, bytes + sizeof(T));
+    memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+template<typename T> bool
+read(istream& is, T& value, bool swap)
+{
+    if(!is.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    {
+        return false;
+    }
+    if(swap)
+    {
+        value = swapBytes(value);
+    }
+    return true;
+}
+
+string
+formatTimestamp(long long int timestamp)
+{
+    auto seconds = static_cast<time_t>(timestamp / 1000000000);
+    auto nanoseconds = timestamp % 1000000000;
+    tm t;
+#ifdef _WIN32
+    gmtime_s(&t, &seconds);
+#else
+    gmtime_r(&seconds, &t);
+#endif
+    ostringstream os;
+    os << put_time(&t, "%Y-%m-%dT%H:%M:%S") << '.' << setw(9) << setfill('0') << nanoseconds << 'Z';
+    return os.str();
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    string file;
+    long long int topic = -1;
+    long long int element = -1;
+    long long int thread = -1;
+    try
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            auto pos = arg.find('=');
+            string value = pos == string::npos ? string() : arg.substr(pos + 1);
+            if(arg == "-v" || arg == "--version")
+            {
+                cout << DATASTORM_STRING_VERSION << endl;
+                return 0;
+            }
+            else if(arg == "-h" || arg == "--help")
+            {
+                usage(argv[0]);
+                return 0;
+            }
+            else if(arg.compare(0, pos, "--topic") == 0 && pos != string::npos)
+            {
+                topic = stoll(value);
+            }
+            else if(arg.compare(0, pos, "--element") == 0 && pos != string::npos)
+            {
+                element = stoll(value);
+            }
+            else if(arg.compare(0, pos, "--thread") == 0 && pos != string::npos)
+            {
+                thread = stoll(value);
+            }
+            else if(file.empty() && arg[0] != '-')
+            {
+                file = arg;
+            }
+            else
+            {
+                cerr << "unrecognized argument `" << arg << "'" << endl;
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch(const std::exception&)
+    {
+        cerr << "invalid argument" << endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    if(file.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ifstream is(file, ios::binary);
+    if(!is)
+    {
+        cerr << "can't open `" << file << "'" << endl;
+        return 1;
+    }
+
+    //
+    // The dump is written in the byte order of the recording host, the version is used to detect it.
+    //
+    FlightRecordHeader header;
+    if(!is.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+       memcmp(header.magic, flightRecordMagic, sizeof(header.magic)) != 0)
+    {
+        cerr << "`" << file << "' isn't a DataStorm flight recording" << endl;
+        return 1;
+    }
+    bool swap = header.version != flightRecordVersion;
+    if(swap)
+    {
+        header.version = swapBytes(header.version);
+        header.recordSize = swapBytes(header.recordSize);
+        header.threadCount = swapBytes(header.threadCount);
+    }
+    if(header.version != flightRecordVersion || header.recordSize != sizeof(FlightRecord))
+    {
+        cerr << "unsupported flight recording version " << header.version << endl;
+        return 1;
+    }
+
+    vector<FlightRecord> records;
+    for(uint32_t i = 0; i < header.threadCount; ++i)
+    {
+        FlightRecordThread t;
+        if(!read(is, t.thread, swap) || !read(is, t.count, swap))
+        {
+            cerr << "`" << file << "' is truncated" << endl;
+            return 1;
+        }
+        for(uint32_t j = 0; j < t.count; ++j)
+        {
+            FlightRecord r;
+            if(!read(is, r.timestamp, swap) || !read(is, r.topic, swap) || !read(is, r.element, swap) ||
+               !read(is, r.sample, swap) || !read(is, r.event, swap) || !read(is, r.thread, swap))
+            {
+                cerr << "`" << file << "' is truncated" << endl;
+                return 1;
+            }
+            if((topic < 0 || r.topic == topic) && (element < 0 || r.element == element) &&
+               (thread < 0 || r.thread == thread))
+            {
+                records.push_back(r);
+            }
+        }
+    }
+
+    //
+    // Merge the events of all the threads in time order.
+    //
+    stable_sort(records.begin(), records.end(), [](const FlightRecord& lhs, const FlightRecord& rhs)
+                {
+                    return lhs.timestamp < rhs.timestamp;
+                });
+
+    for(const auto& r : records)
+    {
+        cout << formatTimestamp(r.timestamp) << " thread=" << r.thread << ' '
+             << toString(static_cast<FlightEvent>(r.event)) << " topic=" << r.topic << " element=" << r.element
+             << " sample=" << r.sample << '\n';
+    }
+    return 0;
+}
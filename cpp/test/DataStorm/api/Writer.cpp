@@ -1,11 +1,18 @@
 //
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
+#include <DataStorm/Admin.h>
 #include <DataStorm/DataStorm.h>
 
 #include <Test.h>
 #include <TestCommon.h>
 
+#include <thread>
+
+#ifndef _WIN32
+#   include <poll.h>
+#endif
+
 using namespace DataStorm;
 using namespace std;
 using namespace Test;
@@ -200,6 +207,282 @@ main(int argc, char* argv[])
     }
     cout << "ok" << endl;
 
+    cout << "testing async writer... " << flush;
+    {
+        Topic<string, string> topic(node, "async");
+        WriterConfig config(-1, 0, ClearHistoryPolicy::Never, Ice::nullopt, true);
+        auto writer = makeSingleKeyWriter(topic, "key", "", config);
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+        writer.waitForReaders();
+
+        for(int i = 0; i < 100; ++i)
+        {
+            writer.update(to_string(i));
+        }
+        writer.flush();
+        test(writer.getAll().size() == 100 && writer.getLast().getValue() == "99");
+
+        reader.waitForUnread(100);
+        auto samples = reader.getAllUnread();
+        test(samples.size() == 100);
+        for(int i = 0; i < 100; ++i)
+        {
+            test(samples[static_cast<size_t>(i)].getValue() == to_string(i));
+        }
+
+        writer.update("100");
+        writer.flushAsync().get();
+        test(writer.getLast().getValue() == "100");
+    }
+    cout << "ok" << endl;
+
+#ifndef _WIN32
+    cout << "testing notification handle... " << flush;
+    {
+        Topic<string, string> topic(node, "notification");
+        auto writer = makeSingleKeyWriter(topic, "key");
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+
+        auto readable = [&reader](int timeout)
+        {
+            pollfd fd = { reader.getNotificationHandle(), POLLIN, 0 };
+            return poll(&fd, 1, timeout) == 1;
+        };
+
+        test(!readable(0));
+        test(reader.getUnread(10).empty());
+
+        writer.waitForReaders();
+        writer.update("value1");
+        writer.update("value2");
+        writer.update("value3");
+        test(readable(10000));
+
+        reader.waitForUnread(3);
+        auto samples = reader.getUnread(2);
+        test(samples.size() == 2 && samples[0].getValue() == "value1" && samples[1].getValue() == "value2");
+        test(readable(0));
+        test(reader.getUnread(2).size() == 1);
+        test(!readable(0));
+
+        writer.update("value4");
+        test(readable(10000));
+        test(reader.getNextUnread().getValue() == "value4");
+        test(!readable(0));
+    }
+    cout << "ok" << endl;
+#endif
+
+    cout << "testing sample batch... " << flush;
+    {
+        Topic<string, double> topic(node, "batch");
+        auto writer = makeMultiKeyWriter(topic, { "k1", "k2" });
+        auto reader = makeMultiKeyReader(topic, { "k1", "k2" });
+
+        writer.waitForReaders();
+        writer.add("k1", 1.0);
+        writer.add("k2", 10.0);
+        writer.update("k1", 3.0);
+        writer.update("k2", 20.0);
+        writer.remove("k1");
+        reader.waitForUnread(5);
+
+        SampleBatch<string, double> batch;
+        reader.getUnread(2, batch);
+        test(batch.size() == 2 && batch.getKeys() == vector<string>({ "k1", "k2" }));
+        reader.getAllUnread(batch);
+        test(batch.size() == 5 && batch.getKeys().size() == 2);
+        test(batch.getEvents()[4] == SampleEvent::Remove && batch.getKeyIndexes()[4] == 0);
+
+        auto aggregates = batch.aggregate();
+        test(aggregates[0].min == 1.0 && aggregates[0].max == 3.0 && aggregates[0].sum == 4.0);
+        test(aggregates[0].count == 2 && aggregates[1].count == 2 && aggregates[1].sum == 30.0);
+
+        chrono::system_clock::time_point from(chrono::microseconds(batch.getTimeStamps()[3]));
+        auto aggregate = batch.aggregate(1, from);
+        test(aggregate.count >= 1 && aggregate.max == 20.0);
+
+        auto price = [](double value) { return value; };
+        auto quantity = [](double value) { return value; };
+        test(batch.vwap(price, quantity)[1] == 500.0 / 30.0);
+        test(batch.vwap(0, price, quantity) == 10.0 / 4.0);
+
+        batch.clear();
+        test(batch.empty() && batch.getKeys().empty());
+    }
+    cout << "ok" << endl;
+
+    cout << "testing max update rate... " << flush;
+    {
+        Topic<string, int> topic(node, "maxupdaterate");
+        auto writer = makeSingleKeyWriter(topic, "key");
+        ReaderConfig config;
+        config.maxUpdateRate = 10;
+        auto reader = makeSingleKeyReader(topic, "key", "", config);
+
+        writer.waitForReaders();
+        writer.add(0);
+        for(int i = 1; i <= 100; ++i)
+        {
+            writer.update(i);
+        }
+
+        // The updates published during an update interval are conflated, the latest update is eventually sent.
+        test(reader.getNextUnread().getEvent() == SampleEvent::Add);
+        int count = 0;
+        while(reader.getNextUnread().getValue() != 100)
+        {
+            ++count;
+        }
+        test(count < 99);
+
+        writer.remove();
+        test(reader.getNextUnread().getEvent() == SampleEvent::Remove);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing keep latest per key discard policy... " << flush;
+    {
+        Topic<string, int> topic(node, "keeplatestperkey");
+        auto writer = makeMultiKeyWriter(topic, { "k1", "k2", "k3" });
+        auto reader = makeMultiKeyReader(topic, { "k1", "k2", "k3" }, "",
+                                         ReaderConfig(-1, Ice::nullopt, ClearHistoryPolicy::Never,
+                                                      DiscardPolicy::KeepLatestPerKey));
+
+        writer.waitForReaders();
+        writer.add("k1", 1);
+        writer.add("k2", 10);
+        writer.update("k1", 2);
+        writer.update("k1", 3);
+        writer.update("k2", 20);
+        writer.add("k3", 100);
+
+        // k3 is the last sample published, once it's queued the previous samples are queued or replaced.
+        reader.waitForUnread(3);
+        auto samples = reader.getAllUnread();
+        test(samples.size() == 3);
+        test(samples[0].getKey() == "k1" && samples[0].getValue() == 3);
+        test(samples[1].getKey() == "k2" && samples[1].getValue() == 20);
+        test(samples[2].getKey() == "k3" && samples[2].getValue() == 100);
+
+        writer.update("k2", 30);
+        writer.update("k2", 40);
+        writer.update("k3", 200);
+        reader.waitForUnread(2);
+        samples = reader.getAllUnread();
+        test(samples.size() == 2 && samples[0].getValue() == 40 && samples[1].getValue() == 200);
+    }
+    {
+        Topic<string, int> topic(node, "keeplatestperkeylifetime");
+        auto writer = makeMultiKeyWriter(topic, { "k1", "k2", "k3" });
+        auto reader = makeMultiKeyReader(topic, { "k1", "k2", "k3" }, "",
+                                         ReaderConfig(-1, 1000, ClearHistoryPolicy::Never,
+                                                      DiscardPolicy::KeepLatestPerKey));
+        auto marker = makeSingleKeyReader(topic, "k3");
+
+        writer.waitForReaders(2);
+        writer.add("k1", 1);
+        writer.add("k2", 10);
+        reader.waitForUnread(2);
+
+        // The k1 sample at the front of the queue is replaced by a recent sample, the k2 sample expires first.
+        this_thread::sleep_for(chrono::milliseconds(600));
+        writer.update("k1", 2);
+        this_thread::sleep_for(chrono::milliseconds(600));
+
+        // The expired k2 sample is removed from the middle of the queue, the next k1 sample still replaces k1.
+        writer.update("k1", 3);
+        writer.add("k3", 100);
+        test(marker.getNextUnread().getValue() == 100);
+        auto samples = reader.getAllUnread();
+        test(samples.size() == 2);
+        test(samples[0].getKey() == "k1" && samples[0].getValue() == 3);
+        test(samples[1].getKey() == "k3" && samples[1].getValue() == 100);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing flow control... " << flush;
+    {
+        Topic<string, int> topic(node, "flowcontrol");
+        ReaderConfig readerConfig(-1, 0, ClearHistoryPolicy::Never);
+        readerConfig.maxUnreadSamples = 10;
+        auto reader = makeSingleKeyReader(topic, "key", "", readerConfig);
+
+        // The samples published while the reader has no credit are dropped.
+        auto writer = makeSingleKeyWriter(topic, "key");
+        writer.waitForReaders();
+        for(int i = 0; i < 100; ++i)
+        {
+            writer.update(i);
+        }
+        reader.waitForUnread(10);
+        auto samples = reader.getAllUnread();
+        test(samples.size() == 10 && samples[0].getValue() == 0 && samples[9].getValue() == 9);
+
+        // A blocking writer waits for the reader to grant credit, the reader gets all the samples.
+        WriterConfig writerConfig(-1, 0, ClearHistoryPolicy::Never, Ice::nullopt, true, FlowControlPolicy::Block);
+        auto blockingWriter = makeSingleKeyWriter(topic, "key", "", writerConfig);
+        blockingWriter.waitForReaders();
+        for(int i = 0; i < 100; ++i)
+        {
+            blockingWriter.update(i);
+        }
+        for(int i = 0; i < 100; ++i)
+        {
+            test(reader.getNextUnread().getValue() == i);
+        }
+        blockingWriter.flush();
+    }
+    cout << "ok" << endl;
+
+    cout << "testing batch writer... " << flush;
+    {
+        Topic<string, int> topic(node, "batch");
+        WriterConfig config;
+        config.batch = true;
+        config.batchSize = 256;
+        auto writer = makeSingleKeyWriter(topic, "key", "", config);
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+
+        writer.waitForReaders();
+        for(int i = 0; i < 100; ++i)
+        {
+            writer.update(i);
+        }
+
+        // Batched samples are flushed when the batch size is reached or after the flush interval.
+        for(int i = 0; i < 100; ++i)
+        {
+            test(reader.getNextUnread().getValue() == i);
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing copy-on-write values... " << flush;
+    {
+        Shared<string> value1("value");
+        auto value2 = value1;
+        test(&value1.get() == &value2.get());
+        value2.write() += "2";
+        test(*value1 == "value" && *value2 == "value2");
+        test(Shared<string>().get().empty());
+
+        Topic<string, Shared<string>> topic(node, "shared");
+        topic.setUpdater<string>("append", [](Shared<string>& value, string suffix) { value.write() += suffix; });
+        auto writer = makeSingleKeyWriter(topic, "key");
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+
+        writer.waitForReaders();
+        writer.add(Shared<string>("value"));
+        writer.partialUpdate<string>("append")("1");
+        writer.partialUpdate<string>("append")("2");
+
+        test(*reader.getNextUnread().getValue() == "value");
+        test(*reader.getNextUnread().getValue() == "value1");
+        test(*reader.getNextUnread().getValue() == "value12");
+    }
+    cout << "ok" << endl;
+
     cout << "testing reader... " << flush;
     {
         Topic<string, string> topic(node, "topic");
@@ -309,5 +592,103 @@ main(int argc, char* argv[])
     }
     cout << "ok" << endl;
 
+    cout << "testing metrics... " << flush;
+    {
+        Topic<string, string> topic(node, "metrics");
+        auto writer = makeSingleKeyWriter(topic, "key");
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+        writer.waitForReaders();
+        writer.update("value1");
+        writer.update("value2");
+        reader.waitForUnread(2);
+
+        auto getTopicMetrics = [&node](bool reader)
+        {
+            for(const auto& metrics : node.getMetrics().topics)
+            {
+                if(metrics.name == "metrics" && metrics.reader == reader)
+                {
+                    return metrics;
+                }
+            }
+            test(false);
+            return TopicMetrics();
+        };
+
+        auto writerMetrics = getTopicMetrics(false);
+        test(writerMetrics.published == 2);
+        test(writerMetrics.elements.size() == 1);
+        test(!writerMetrics.elements[0].reader && writerMetrics.elements[0].published == 2);
+
+        auto readerMetrics = getTopicMetrics(true);
+        test(readerMetrics.queued == 2 && readerMetrics.historyDepth == 2);
+        test(readerMetrics.elements.size() == 1);
+        test(readerMetrics.elements[0].reader && readerMetrics.elements[0].queued == 2);
+        test(readerMetrics.elements[0].listenerCount == 1);
+
+        reader.getAllUnread();
+        test(getTopicMetrics(true).historyDepth == 0);
+
+        // The metrics facet is only registered if enabled
+        test(!node.getCommunicator()->findAdminFacet("DataStorm.Metrics"));
+
+        Ice::InitializationData initData;
+        initData.properties = node.getCommunicator()->getProperties()->clone();
+        initData.properties->setProperty("DataStorm.Node.Metrics.Enabled", "1");
+        Ice::CommunicatorHolder holder(initData);
+        Node metricsNode(holder.communicator());
+        test(dynamic_pointer_cast<MetricsAdmin>(holder.communicator()->findAdminFacet("DataStorm.Metrics")));
+    }
+    cout << "ok" << endl;
+
+    cout << "testing admin... " << flush;
+    {
+        test(!node.getCommunicator()->findAdminFacet("DataStorm.Admin"));
+
+        Ice::InitializationData initData;
+        initData.properties = node.getCommunicator()->getProperties()->clone();
+        initData.properties->setProperty("DataStorm.Node.Admin.Enabled", "1");
+        Ice::CommunicatorHolder holder(initData);
+        Node adminNode(holder.communicator());
+
+        Topic<string, string> topic(adminNode, "admin");
+        auto writer = makeSingleKeyWriter(topic, "key", "", WriterConfig(5));
+        auto reader = makeSingleKeyReader(topic, "key", "adminReader", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+        writer.waitForReaders();
+        writer.update("value");
+        reader.waitForUnread(1);
+
+        auto admin = dynamic_pointer_cast<NodeAdmin>(holder.communicator()->findAdminFacet("DataStorm.Admin"));
+        test(admin);
+        auto description = admin->describe(Ice::emptyCurrent);
+        test(description.callbackQueueDepth >= 0 && description.timerQueueSize >= 0);
+        test(description.topics.size() == 2);
+        for(const auto& t : description.topics)
+        {
+            test(t.name == "admin");
+            test(t.elements.size() == 1);
+            const auto& element = t.elements[0];
+            test(element.reader == t.reader);
+            test(element.historyDepth == 1);
+            test(element.listenerCount == 1);
+            test(element.connectedElements.size() == 1);
+            if(t.reader)
+            {
+                test(element.config.at("name") == "adminReader");
+                test(element.config.at("clearHistory") == "Never");
+                test(element.config.at("discardPolicy") == "None");
+            }
+            else
+            {
+                test(element.config.at("sampleCount") == "5");
+                test(element.connectedElements[0] == "adminReader");
+            }
+        }
+
+        auto recording = admin->getFlightRecording(Ice::emptyCurrent);
+        test(recording.size() > 16 && string(recording.begin(), recording.begin() + 4) == "DSFR");
+    }
+    cout << "ok" << endl;
+
     return 0;
 }
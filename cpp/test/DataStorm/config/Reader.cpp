@@ -302,5 +302,34 @@ main(int argc, char* argv[])
         readers.update(true); // Reader is done
     }
 
+    // Reader latency statistics
+    {
+        readers.update(false);
+
+        Topic<string, int> topic(node, "latencyTopic");
+        ReaderConfig config;
+        config.latencyStatistics = true;
+        auto reader = makeSingleKeyReader(topic, "elem", "", config);
+        auto other = makeSingleKeyReader(topic, "elem");
+        test(reader.getLatencyStatistics().count == 0);
+        while(reader.getNextUnread().getValue() != 9);
+
+        auto statistics = reader.getLatencyStatistics();
+        test(statistics.count == 10);
+        test(statistics.min <= statistics.p50 && statistics.p50 <= statistics.p90);
+        test(statistics.p90 <= statistics.p99 && statistics.p99 <= statistics.p999);
+        test(statistics.p999 <= statistics.max && statistics.mean <= statistics.max);
+        test(other.getLatencyStatistics().count == 0);
+        test(topic.getLatencyStatistics().count == 10);
+
+        reader.resetLatencyStatistics();
+        test(reader.getLatencyStatistics().count == 0);
+        test(topic.getLatencyStatistics().count == 10);
+        topic.resetLatencyStatistics();
+        test(topic.getLatencyStatistics().count == 0);
+
+        readers.update(true); // Reader is done
+    }
+
     return 0;
 }
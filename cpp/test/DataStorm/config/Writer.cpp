@@ -314,5 +314,18 @@ main(int argc, char* argv[])
     }
     cout << "ok" << endl;
 
+    cout << "testing latency statistics... " << flush;
+    {
+        Topic<string, int> topic(node, "latencyTopic");
+        auto writer = makeSingleKeyWriter(topic, "elem");
+        writer.waitForReaders();
+        for(int i = 0; i < 10; ++i)
+        {
+            writer.update(i);
+        }
+        while(!readers.getNextUnread().getValue()); // Wait for reader to be done
+    }
+    cout << "ok" << endl;
+
     return 0;
 }
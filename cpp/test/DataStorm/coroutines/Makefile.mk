@@ -0,0 +1,12 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# The coroutine awaitables require C++20, the test is built with the C++20 standard.
+#
+$(test)_cppflags      := -DICE_CPP11_MAPPING -std=c++20
+
+tests += $(test)
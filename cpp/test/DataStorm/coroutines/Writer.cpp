@@ -0,0 +1,101 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+#include <memory>
+
+using namespace DataStorm;
+using namespace std;
+
+#ifdef DATASTORM_HAS_COROUTINES
+namespace
+{
+
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+}
+#endif
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+#ifdef DATASTORM_HAS_COROUTINES
+    cout << "testing coroutines... " << flush;
+    {
+        Topic<string, string> topic(node, "coroutines");
+        auto writer = makeSingleKeyWriter(topic, "key");
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+
+        promise<vector<string>> result;
+        auto readerTask = [&reader, &result]() -> Task
+        {
+            co_await reader.writers();
+            vector<string> values;
+            values.push_back((co_await reader.nextUnread()).getValue());
+            co_await reader.unread(2);
+            values.push_back((co_await reader.nextUnread()).getValue());
+            values.push_back((co_await reader.nextUnread()).getValue());
+            result.set_value(move(values));
+        };
+        readerTask();
+
+        promise<void> connected;
+        auto writerTask = [&writer, &connected]() -> Task
+        {
+            co_await writer.readers();
+            connected.set_value();
+        };
+        writerTask();
+        connected.get_future().get();
+
+        writer.update("value1");
+        writer.update("value2");
+        writer.update("value3");
+        test(result.get_future().get() == vector<string>({ "value1", "value2", "value3" }));
+    }
+    cout << "ok" << endl;
+
+    cout << "testing coroutines with destroyed reader... " << flush;
+    {
+        Topic<string, string> topic(node, "coroutinesdestroy");
+        auto reader = make_unique<SingleKeyReader<string, string>>(makeSingleKeyReader(topic, "key"));
+
+        promise<bool> result;
+        auto readerTask = [&reader, &result]() -> Task
+        {
+            try
+            {
+                co_await reader->nextUnread();
+                result.set_value(false);
+            }
+            catch(const std::logic_error&)
+            {
+                result.set_value(true);
+            }
+        };
+        readerTask();
+
+        reader.reset();
+        test(result.get_future().get());
+    }
+    cout << "ok" << endl;
+#else
+    cout << "coroutines are not supported by this compiler, skipping tests" << endl;
+#endif
+    return 0;
+}
@@ -0,0 +1,7 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+TestSuite(__file__, [ ClientTestCase() ])
@@ -387,5 +387,19 @@ main(int argc, char* argv[])
         }
      }
 
+    {
+        Topic<string, int> topic(node, "lanes");
+
+        auto reader = makeAnyKeyReader(topic, "", config);
+        reader.waitForWriters(2);
+        map<string, int> values { { "elem1", 0 }, { "elem2", 0 } };
+        for(int i = 0; i < 200; ++i)
+        {
+            auto sample = reader.getNextUnread();
+            test(sample.getValue() == values[sample.getKey()]++);
+        }
+        test(values["elem1"] == 100 && values["elem2"] == 100);
+    }
+
     return 0;
 }
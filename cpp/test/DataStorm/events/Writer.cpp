@@ -367,6 +367,29 @@ main(int argc, char* argv[])
     }
     cout << "ok" << endl;
 
+    cout << "testing writer lanes... " << flush;
+    {
+        Topic<string, int> topic(node, "lanes");
+
+        WriterConfig laneConfig = config;
+        laneConfig.lane = 1;
+        auto writer1 = makeSingleKeyWriter(topic, "elem1", "", laneConfig);
+        auto writer2 = makeSingleKeyWriter(topic, "elem2", "", config);
+        writer1.waitForReaders(1);
+        writer2.waitForReaders(1);
+
+        // The samples of each writer are received in order, whether or not they are sent over the lane connection.
+        for(int i = 0; i < 100; ++i)
+        {
+            writer1.update(i);
+            writer2.update(i);
+        }
+
+        writer1.waitForNoReaders();
+        writer2.waitForNoReaders();
+    }
+    cout << "ok" << endl;
+
     cout << "testing topic collocated key reader and writer... " << flush;
     {
         Topic<string, string> topic(node, "collocated");
@@ -0,0 +1,34 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    int count = argc > 1 ? stoi(argv[1]) : 1000;
+
+    vector<unique_ptr<Topic<int, string>>> topics;
+    vector<unique_ptr<SingleKeyReader<int, string>>> readers;
+    topics.reserve(count);
+    readers.reserve(count);
+    for(int i = 0; i < count; ++i)
+    {
+        topics.emplace_back(new Topic<int, string>(node, "topic" + to_string(i)));
+        readers.emplace_back(new SingleKeyReader<int, string>(makeSingleKeyReader(*topics.back(), 0)));
+    }
+    cout << "topics ready" << endl;
+
+    for(const auto& reader : readers)
+    {
+        test(reader->getNextUnread().getValue() == "done");
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    int count = argc > 1 ? stoi(argv[1]) : 1000;
+
+    vector<unique_ptr<Topic<int, string>>> topics;
+    vector<unique_ptr<SingleKeyWriter<int, string>>> writers;
+    topics.reserve(count);
+    writers.reserve(count);
+
+    for(int i = 0; i < count; ++i)
+    {
+        topics.emplace_back(new Topic<int, string>(node, "topic" + to_string(i)));
+        writers.emplace_back(new SingleKeyWriter<int, string>(makeSingleKeyWriter(*topics.back(), 0)));
+    }
+
+    //
+    // The test driver starts the node the reader and writer connect to once the topics are created
+    //
+    cout << "topics ready" << endl;
+
+    cout << "establishing session with " << count << " topics... " << flush;
+    auto start = chrono::steady_clock::now();
+    for(const auto& writer : writers)
+    {
+        writer->waitForReaders();
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    cout << "ok (" << elapsed.count() << "ms)" << endl;
+
+    for(const auto& writer : writers)
+    {
+        writer->update("done");
+    }
+    for(const auto& writer : writers)
+    {
+        writer->waitForNoReaders();
+    }
+    return 0;
+}
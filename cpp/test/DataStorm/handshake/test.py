@@ -0,0 +1,54 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# Measures the time required to establish the session between two nodes which share many topics. The reader and
+# writer create their topics before the node they connect to is started, the session establishment therefore
+# includes all the topics. The run with 10000 topics is only enabled with the --benchmarks option.
+#
+clientProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 0,
+    "DataStorm.Node.ConnectTo": "tcp -p 12345",
+    "DataStorm.Node.RetryDelay": 10,
+    "DataStorm.Node.RetryMultiplier": 1
+}
+
+nodeProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 1,
+    "DataStorm.Node.Server.Endpoints": "tcp -p 12345",
+    "DataStorm.Node.ConnectTo": ""
+}
+
+class HandshakeTestCase(ClientServerTestCase):
+
+    def __init__(self, count):
+        ClientServerTestCase.__init__(self, name="session establishment with {0} topics".format(count),
+                                      client=Writer(args=[str(count)], props=clientProps),
+                                      server=Reader(args=[str(count)], props=clientProps, ready="topics"))
+        self.node = Node(props=nodeProps)
+
+    def runClientSide(self, current):
+        # The node is only started once the writer created its topics
+        writer = self.clients[0]
+        writer.setup(current)
+        success = False
+        try:
+            writer.start(current)
+            current.processes[writer].waitReady("topics", 1, 300)
+            self._startServer(current, self.node)
+            writer.stop(current, True)
+            success = True
+        finally:
+            if not success:
+                writer.stop(current, False)
+            writer.teardown(current, success)
+
+    def teardownClientSide(self, current, success):
+        self.node.shutdown(current)
+
+TestSuite(__file__, [HandshakeTestCase(count) for count in [10, 1000] + ([10000] if component.benchmarks else [])])
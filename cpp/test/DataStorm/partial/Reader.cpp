@@ -26,6 +26,10 @@ main(int argc, char* argv[])
                             {
                                 stock.price = price;
                             });
+    topic.setUpdater<float>("lastBid", [](Stock& stock, float lastBid)
+                            {
+                                stock.lastBid = lastBid;
+                            });
 
     {
         auto reader = makeSingleKeyReader(topic, "AAPL");
@@ -68,5 +72,18 @@ main(int argc, char* argv[])
         test(sample.getValue().price == 18.0f);
     }
 
+    {
+        auto reader = makeSingleKeyReader(topic, "GOOG");
+        auto sample = reader.getNextUnread();
+        test(sample.getEvent() == SampleEvent::Add);
+
+        // The partial updates of a composite update are received with a single sample
+        sample = reader.getNextUnread();
+        test(sample.getEvent() == SampleEvent::PartialUpdate);
+        test(sample.getValue().price == 15.0f && sample.getValue().lastBid == 16.0f);
+        test(sample.getValue().laskAsk == 14.0f);
+        test(!reader.hasUnread());
+    }
+
     return 0;
 }
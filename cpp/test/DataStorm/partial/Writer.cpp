@@ -30,6 +30,10 @@ main(int argc, char* argv[])
                             {
                                 stock.price = price;
                             });
+    topic.setUpdater<float>("lastBid", [](Stock& stock, float lastBid)
+                            {
+                                stock.lastBid = lastBid;
+                            });
 
     cout << "testing partial update... " << flush;
     {
@@ -42,5 +46,46 @@ main(int argc, char* argv[])
     }
     cout << "ok" << endl;
 
+    cout << "testing composite partial update... " << flush;
+    {
+        //
+        // The reader of a node which doesn't apply composite partial updates, like the readers of previous
+        // versions, only has the updaters of the partial updates. It receives the composite update as a full
+        // update computed by the writer.
+        //
+        Ice::InitializationData initData;
+        initData.properties = node.getCommunicator()->getProperties()->clone();
+        initData.properties->setProperty("DataStorm.Node.CompositeUpdates", "0");
+        Ice::CommunicatorHolder holder(initData);
+        Node compatNode(holder.communicator());
+        Topic<string, Stock> compatTopic(compatNode, "topic");
+        compatTopic.setUpdater<float>("price", [](Stock& stock, float price)
+                                      {
+                                          stock.price = price;
+                                      });
+        compatTopic.setUpdater<float>("lastBid", [](Stock& stock, float lastBid)
+                                      {
+                                          stock.lastBid = lastBid;
+                                      });
+
+        auto writer = makeSingleKeyWriter(topic, "GOOG");
+        {
+            auto compatReader = makeSingleKeyReader(compatTopic, "GOOG");
+            writer.waitForReaders(2);
+            writer.add(Stock(12.0f, 13.0f, 14.0f));
+            writer.compositeUpdate().add<float>("price", 15.0f).add<float>("lastBid", 16.0f).publish();
+
+            auto sample = compatReader.getNextUnread();
+            test(sample.getEvent() == SampleEvent::Add);
+
+            sample = compatReader.getNextUnread();
+            test(sample.getEvent() == SampleEvent::Update);
+            test(sample.getValue().price == 15.0f && sample.getValue().lastBid == 16.0f);
+            test(sample.getValue().laskAsk == 14.0f);
+        }
+        writer.waitForNoReaders();
+    }
+    cout << "ok" << endl;
+
     return 0;
 }
@@ -0,0 +1,265 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#pragma once
+
+#include <DataStorm/DataStorm.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace Perf
+{
+
+using Payload = std::vector<unsigned char>;
+using PerfTopic = DataStorm::Topic<int, Payload, std::string>;
+
+//
+// The benchmark parameters, they are provided with --name=value arguments by test.py.
+//
+struct Options
+{
+    int samples = 10000;
+    int payload = 64;
+    int keys = 1;
+    int readers = 1;
+    bool filter = false;
+    bool partial = false;
+    bool batch = false;
+    bool collocated = false;
+    std::string output;
+
+    std::string
+    name() const
+    {
+        std::ostringstream os;
+        os << (collocated ? "collocated" : "tcp") << " payload=" << payload << " keys=" << keys
+           << " readers=" << readers;
+        if(filter)
+        {
+            os << " filter";
+        }
+        if(partial)
+        {
+            os << " partial";
+        }
+        if(batch)
+        {
+            os << " batch";
+        }
+        return os.str();
+    }
+};
+
+inline Options
+parseOptions(int argc, char* argv[])
+{
+    Options options;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto pos = arg.find('=');
+        std::string name = arg.substr(0, pos);
+        std::string value = pos == std::string::npos ? std::string() : arg.substr(pos + 1);
+        if(name == "--samples")
+        {
+            options.samples = std::stoi(value);
+        }
+        else if(name == "--payload")
+        {
+            options.payload = std::stoi(value);
+        }
+        else if(name == "--keys")
+        {
+            options.keys = std::stoi(value);
+        }
+        else if(name == "--readers")
+        {
+            options.readers = std::stoi(value);
+        }
+        else if(name == "--filter")
+        {
+            options.filter = true;
+        }
+        else if(name == "--partial")
+        {
+            options.partial = true;
+        }
+        else if(name == "--batch")
+        {
+            options.batch = true;
+        }
+        else if(name == "--collocated")
+        {
+            options.collocated = true;
+        }
+        else if(name == "--output")
+        {
+            options.output = value;
+        }
+    }
+    return options;
+}
+
+//
+// The "copy" partial update overwrites the beginning of the payload with the update bytes.
+//
+inline void
+setUpdaters(PerfTopic& topic)
+{
+    topic.setUpdater<Payload>("copy", [](Payload& value, const Payload& update)
+                              {
+                                  std::copy(update.begin(), update.begin() + std::min(update.size(), value.size()),
+                                            value.begin());
+                              });
+}
+
+//
+// The collector creates the readers and records the latency of each received sample, the latency is computed
+// from the sample timestamp set by the writer. The writer and readers must run on the same host.
+//
+class Collector
+{
+public:
+
+    Collector(PerfTopic& topic, const Options& options) :
+        _options(options),
+        _expected(static_cast<long long>(options.samples) * options.readers),
+        _received(0),
+        _bytes(0)
+    {
+        _latencies.reserve(static_cast<size_t>(_expected));
+
+        //
+        // Don't keep the samples in the reader queues, the samples are only consumed by the callback.
+        //
+        DataStorm::ReaderConfig config(0);
+        for(int i = 0; i < options.readers; ++i)
+        {
+            if(options.filter)
+            {
+                _filteredReaders.emplace_back(
+                    new DataStorm::FilteredKeyReader<int, Payload, std::string>(
+                        DataStorm::makeFilteredKeyReader(topic, DataStorm::Filter<std::string>("_regex", ".*"),
+                                                         "", config)));
+                _filteredReaders.back()->onSamples(nullptr, [this](const Sample& sample) { received(sample); });
+            }
+            else
+            {
+                _readers.emplace_back(
+                    new DataStorm::MultiKeyReader<int, Payload, std::string>(
+                        DataStorm::makeAnyKeyReader(topic, "", config)));
+                _readers.back()->onSamples(nullptr, [this](const Sample& sample) { received(sample); });
+            }
+        }
+    }
+
+    void
+    wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cond.wait(lock, [this] { return _received >= _expected; });
+    }
+
+    void
+    report()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto elapsed = std::chrono::duration<double>(_last - _first).count();
+        if(elapsed <= 0)
+        {
+            elapsed = 1e-6;
+        }
+        double msgs = _received / elapsed;
+        double mbs = _bytes / elapsed / (1024.0 * 1024.0);
+
+        std::sort(_latencies.begin(), _latencies.end());
+        auto p50 = percentile(0.5);
+        auto p99 = percentile(0.99);
+        auto p999 = percentile(0.999);
+        auto max = _latencies.empty() ? 0 : _latencies.back();
+
+        std::cout << std::fixed << std::setprecision(0) << msgs << " msgs/s, " << std::setprecision(2) << mbs
+                  << " MB/s, latency p50=" << p50 << "us p99=" << p99 << "us p999=" << p999 << "us max=" << max
+                  << "us" << std::endl;
+
+        if(!_options.output.empty())
+        {
+            //
+            // One JSON object per line so that runs can be appended to the same file.
+            //
+            std::ofstream out(_options.output, std::ios::app);
+            out << std::fixed << std::setprecision(2)
+                << "{\"name\": \"" << _options.name() << "\""
+                << ", \"transport\": \"" << (_options.collocated ? "collocated" : "tcp") << "\""
+                << ", \"samples\": " << _options.samples
+                << ", \"payload\": " << _options.payload
+                << ", \"keys\": " << _options.keys
+                << ", \"readers\": " << _options.readers
+                << ", \"filter\": " << (_options.filter ? "true" : "false")
+                << ", \"partial\": " << (_options.partial ? "true" : "false")
+                << ", \"batch\": " << (_options.batch ? "true" : "false")
+                << ", \"msgsPerSec\": " << msgs
+                << ", \"mbPerSec\": " << mbs
+                << ", \"latencyUs\": {\"p50\": " << p50 << ", \"p99\": " << p99 << ", \"p999\": " << p999
+                << ", \"max\": " << max << "}}" << std::endl;
+        }
+    }
+
+private:
+
+    using Sample = DataStorm::Sample<int, Payload, std::string>;
+
+    void
+    received(const Sample& sample)
+    {
+        auto now = std::chrono::system_clock::now();
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - sample.getTimeStamp()).count();
+        auto size = sample.getValue().size();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_received == 0)
+        {
+            _first = std::chrono::steady_clock::now();
+        }
+        _latencies.push_back(latency);
+        _bytes += size;
+        if(++_received == _expected)
+        {
+            _last = std::chrono::steady_clock::now();
+            _cond.notify_all();
+        }
+    }
+
+    long long
+    percentile(double p) const
+    {
+        if(_latencies.empty())
+        {
+            return 0;
+        }
+        auto index = static_cast<size_t>(p * static_cast<double>(_latencies.size() - 1));
+        return _latencies[index];
+    }
+
+    const Options _options;
+    const long long _expected;
+
+    std::vector<std::unique_ptr<DataStorm::MultiKeyReader<int, Payload, std::string>>> _readers;
+    std::vector<std::unique_ptr<DataStorm::FilteredKeyReader<int, Payload, std::string>>> _filteredReaders;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    long long _received;
+    long long _bytes;
+    std::vector<long long> _latencies;
+    std::chrono::steady_clock::time_point _first;
+    std::chrono::steady_clock::time_point _last;
+};
+
+}
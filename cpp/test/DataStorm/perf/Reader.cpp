@@ -0,0 +1,32 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+#include "Perf.h"
+
+using namespace DataStorm;
+using namespace std;
+using namespace Perf;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    auto options = parseOptions(argc, argv);
+
+    PerfTopic topic(node, "perf");
+    setUpdaters(topic);
+
+    //
+    // The readers are destroyed when the collector goes out of scope, the writer waits for the readers to be
+    // gone before exiting.
+    //
+    Collector collector(topic, options);
+    collector.wait();
+    collector.report();
+    return 0;
+}
@@ -0,0 +1,75 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+#include "Perf.h"
+
+using namespace DataStorm;
+using namespace std;
+using namespace Perf;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    auto options = parseOptions(argc, argv);
+
+    PerfTopic topic(node, "perf");
+    setUpdaters(topic);
+
+    //
+    // With the collocated configuration, the readers are created by the writer process and share its node.
+    //
+    unique_ptr<Collector> collector;
+    if(options.collocated)
+    {
+        collector.reset(new Collector(topic, options));
+    }
+
+    vector<int> keys;
+    for(int i = 0; i < options.keys; ++i)
+    {
+        keys.push_back(i);
+    }
+    WriterConfig config;
+    config.batch = options.batch;
+    auto writer = makeMultiKeyWriter(topic, keys, "", config);
+    auto partialUpdate = writer.partialUpdate<Payload>("copy");
+    writer.waitForReaders(static_cast<unsigned int>(options.readers));
+
+    cout << "benchmarking " << options.name() << "... " << flush;
+
+    Payload payload(static_cast<size_t>(options.payload));
+    for(int i = 0; i < options.samples; ++i)
+    {
+        payload[0] = static_cast<unsigned char>(i);
+        int key = i % options.keys;
+        //
+        // The first sample of each key is a full update, the partial update requires a previous value.
+        //
+        if(options.partial && i >= options.keys)
+        {
+            partialUpdate(key, payload);
+        }
+        else
+        {
+            writer.update(key, payload);
+        }
+    }
+
+    if(collector)
+    {
+        collector->wait();
+        collector->report();
+    }
+    else
+    {
+        writer.waitForNoReaders();
+        cout << "ok" << endl;
+    }
+    return 0;
+}
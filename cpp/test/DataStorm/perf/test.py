@@ -0,0 +1,69 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# Measures the throughput (messages/s and MB/s) and the p50/p99/p999 latency of the sample delivery. Without the
+# --benchmarks option, only a few configurations are run with a small number of samples to check that the benchmark
+# works and nothing is written. With --benchmarks, all the configurations are run and the results of each
+# configuration are appended as a JSON object to the results.json file of the writer build directory or to the file
+# of the --benchmark-output directory.
+#
+class PerfTestSuite(TestSuite):
+
+    def setup(self, current):
+        TestSuite.setup(self, current)
+        output = component.getBenchmarkOutput(self, current)
+        if output:
+            if not os.path.exists(os.path.dirname(output)):
+                os.makedirs(os.path.dirname(output))
+            elif os.path.exists(output):
+                os.remove(output)
+
+def options(payload=64, keys=1, readers=1, filter=False, partial=False, batch=False, collocated=False,
+            samples=10000):
+    args = ["--samples={0}".format(samples), "--payload={0}".format(payload), "--keys={0}".format(keys),
+            "--readers={0}".format(readers)]
+    if filter:
+        args.append("--filter")
+    if partial:
+        args.append("--partial")
+    if batch:
+        args.append("--batch")
+    if collocated:
+        args.append("--collocated")
+    def getArgs(process, current):
+        output = component.getBenchmarkOutput(current.testsuite, current)
+        return args + (["--output={0}".format(output)] if output else [])
+    return getArgs
+
+configurations = []
+if component.benchmarks:
+    for payload in [16, 1024, 65536]:
+        configurations.append({ "payload": payload, "samples": 10000 if payload < 65536 else 1000 })
+    for keys in [10, 1000]:
+        configurations.append({ "keys": keys })
+    for readers in [2, 5]:
+        configurations.append({ "readers": readers })
+    configurations.append({ "filter": True })
+    configurations.append({ "partial": True, "payload": 1024 })
+    for payload in [16, 1024]:
+        configurations.append({ "batch": True, "payload": payload })
+else:
+    configurations.append({ "samples": 1000 })
+    configurations.append({ "keys": 10, "readers": 2, "samples": 1000 })
+    configurations.append({ "filter": True, "samples": 1000 })
+    configurations.append({ "partial": True, "samples": 1000 })
+    configurations.append({ "batch": True, "samples": 1000 })
+
+testcases = []
+for c in configurations:
+    name = " ".join("{0}={1}".format(k, v) for (k, v) in sorted(c.items()))
+    testcases.append(ClientServerTestCase(name="tcp " + name,
+                                          client=Writer(args=options(**c)),
+                                          server=Reader(args=options(**c))))
+    testcases.append(ClientTestCase(name="collocated " + name, client=Writer(args=options(collocated=True, **c))))
+
+PerfTestSuite(__file__, testcases)
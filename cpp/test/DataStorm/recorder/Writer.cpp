@@ -0,0 +1,38 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    //
+    // The node dumps the flight recording once destroyed, the recording is decoded and checked by the test script.
+    //
+    Node node(argc, argv);
+
+    cout << "recording samples... " << flush;
+    {
+        Topic<string, int> topic(node, "recorder");
+        auto writer = makeSingleKeyWriter(topic, "key");
+        auto reader = makeSingleKeyReader(topic, "key", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+        writer.waitForReaders();
+        for(int i = 0; i < 10; ++i)
+        {
+            writer.update(i);
+        }
+        for(int i = 0; i < 10; ++i)
+        {
+            test(reader.getNextUnread().getValue() == i);
+        }
+    }
+    cout << "ok" << endl;
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# The writer node dumps its flight recording to the recording.dsfr file of the writer build directory when it's
+# destroyed, the recording is decoded with dsrecorder.
+#
+def getRecording(current):
+    return os.path.join(current.testsuite.getPath(), current.testsuite.getMapping().getBuildDir("writer", current),
+                        "recording.dsfr")
+
+class RecorderTestCase(ClientTestCase):
+
+    def __init__(self):
+        ClientTestCase.__init__(self, client=Writer(props=lambda process, current: {
+            "DataStorm.Node.FlightRecorder.File": getRecording(current)
+        }))
+        self.recorder = Recorder()
+
+    def runClientSide(self, current):
+        if os.path.exists(getRecording(current)):
+            os.remove(getRecording(current))
+
+        ClientTestCase.runClientSide(self, current)
+
+        current.write("decoding the flight recording... ")
+        self.recorder.run(current, args=[getRecording(current)])
+        output = self.recorder.getOutput(current)
+        for event in ["published", "queued"]:
+            count = len([l for l in output.splitlines() if " {0} topic=".format(event) in l])
+            if count != 10:
+                raise RuntimeError("unexpected number of {0} events ({1}):\n{2}".format(event, count, output))
+        current.writeln("ok")
+
+TestSuite(__file__, [ RecorderTestCase() ])
@@ -0,0 +1,60 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+namespace
+{
+
+void
+checkSamples(SingleKeyReader<string, string>& reader)
+{
+    auto sample = reader.getNextUnread();
+    test(sample.getEvent() == SampleEvent::Add);
+    test(sample.getValue() == "value1");
+    test(sample.getOrigin().find("DataStorm.Relay/") == 0);
+
+    sample = reader.getNextUnread();
+    test(sample.getEvent() == SampleEvent::Update);
+    test(sample.getValue() == "value2");
+
+    sample = reader.getNextUnread();
+    test(sample.getEvent() == SampleEvent::Remove);
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    Topic<string, string> topic(node, "relay");
+    Topic<string, bool> controller(node, "controller");
+
+    ReaderConfig config;
+    config.sampleCount = -1;
+    config.clearHistory = ClearHistoryPolicy::Never;
+    topic.setReaderDefaultConfig(config);
+
+    {
+        auto reader = makeSingleKeyReader(topic, "elem1");
+        checkSamples(reader);
+
+        // Late joining reader should be served from the relay history.
+        auto reader2 = makeSingleKeyReader(topic, "elem1");
+        checkSamples(reader2);
+    }
+
+    auto writer = makeSingleKeyWriter(controller, "done");
+    writer.waitForReaders();
+    writer.update(true);
+    writer.waitForNoReaders();
+
+    return 0;
+}
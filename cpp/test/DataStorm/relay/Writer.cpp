@@ -0,0 +1,36 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    Topic<string, string> topic(node, "relay");
+    Topic<string, bool> controller(node, "controller");
+
+    cout << "testing relay... " << flush;
+    {
+        auto writer = makeSingleKeyWriter(topic, "elem1");
+
+        // The writer is only connected to the relay, the readers subscribe to the relay.
+        writer.waitForReaders();
+        writer.add("value1");
+        writer.update("value2");
+        writer.remove();
+
+        // Wait for the reader to be done, the relay reader stays connected.
+        auto reader = makeSingleKeyReader(controller, "done");
+        test(reader.getNextUnread().getValue());
+    }
+    cout << "ok" << endl;
+
+    return 0;
+}
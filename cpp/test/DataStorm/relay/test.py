@@ -0,0 +1,30 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+traceProps = {
+    "DataStorm.Trace.Topic" : 1,
+    "DataStorm.Trace.Session" : 3,
+    "DataStorm.Trace.Data" : 2
+}
+
+clientProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 0,
+    "DataStorm.Node.ConnectTo": "tcp -p 12345"
+}
+
+nodeProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 1,
+    "DataStorm.Node.Server.Endpoints": "tcp -p 12345",
+    "DataStorm.Node.ConnectTo": "",
+    "DataStorm.Node.Relay.Topics": "relay"
+}
+
+TestSuite(__file__, [
+    NodeTestCase(name="relay with node", client=Writer(props=clientProps), server=Reader(props=clientProps),
+                 nodeProps=nodeProps, traceProps=traceProps)
+])
@@ -0,0 +1,60 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <thread>
+
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    //
+    // The control writer is connected before the connection is stalled, its samples are sent by the calling thread
+    // and don't require the client thread pool.
+    //
+    Topic<string, string> controlTopic(node, "control");
+    auto control = makeSingleKeyWriter(controlTopic, "stalled");
+    control.waitForReaders();
+
+    Topic<string, string> topic(node, "slowconsumer");
+    auto reader = makeSingleKeyReader(topic, "element", "", ReaderConfig(-1, 0, ClearHistoryPolicy::Never));
+    auto sample = reader.getNextUnread();
+    test(sample.getEvent() == SampleEvent::Add);
+
+    //
+    // Stall the connection to the writer: the response of the ping is dispatched by the single thread of the client
+    // thread pool, it doesn't read the connection while the response callback sleeps.
+    //
+    auto connection = node.getSessionConnection(sample.getSession());
+    test(connection);
+    promise<void> stalled;
+    auto stall = [&stalled]()
+    {
+        stalled.set_value();
+        this_thread::sleep_for(chrono::seconds(3));
+    };
+    auto proxy = connection->createProxy(Ice::stringToIdentity("stall"));
+    proxy->ice_pingAsync(stall, [stall](exception_ptr) { stall(); });
+    stalled.get_future().wait();
+    control.update("");
+
+    // The updates are conflated, the reader receives increasing values up to the latest update.
+    int value = 0;
+    while(value < 1000)
+    {
+        auto update = reader.getNextUnread();
+        test(update.getEvent() == SampleEvent::Update);
+        auto next = stoi(update.getValue().substr(0, update.getValue().find(':')));
+        test(next > value);
+        value = next;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+using namespace DataStorm;
+using namespace std;
+
+int
+main(int argc, char* argv[])
+{
+    Node node(argc, argv);
+
+    cout << "testing slow consumers... " << flush;
+    {
+        Topic<string, string> controlTopic(node, "control");
+        auto control = makeSingleKeyReader(controlTopic, "stalled");
+
+        Topic<string, string> topic(node, "slowconsumer");
+        WriterConfig config;
+        config.maxBacklogSamples = 10;
+        config.slowConsumerPolicy = SlowConsumerPolicy::Conflate;
+        auto writer = makeSingleKeyWriter(topic, "element", "", config);
+        writer.waitForReaders();
+        writer.add("0");
+
+        // Wait for the reader to stall the dispatch of its connection.
+        control.getNextUnread();
+
+        //
+        // The large samples fill the connection buffers, the backlog of the stalled reader exceeds the
+        // maximum number of samples and the updates are conflated.
+        //
+        string payload(64 * 1024, 'x');
+        for(int i = 1; i <= 1000; ++i)
+        {
+            writer.update(to_string(i) + ":" + payload);
+        }
+
+        bool found = false;
+        for(const auto& metrics : node.getMetrics().topics)
+        {
+            if(metrics.name == "slowconsumer" && !metrics.reader)
+            {
+                test(metrics.slowConsumers > 0);
+                test(metrics.discardedSlowConsumer > 0);
+                found = true;
+            }
+        }
+        test(found);
+
+        // The reader exits once it received the latest update.
+        writer.waitForNoReaders();
+    }
+    cout << "ok" << endl;
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# The reader connects to the writer and stalls the dispatch of its connection, the writer has to detect the slow
+# consumer. The reader client thread pool has a single thread which is blocked by the reader.
+#
+readerProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 0,
+    "DataStorm.Node.ConnectTo": "tcp -p 12345",
+    "Ice.ThreadPool.Client.Size": 1,
+    "Ice.ThreadPool.Client.SizeMax": 1
+}
+
+writerProps = {
+    "DataStorm.Node.Multicast.Enabled": 0,
+    "DataStorm.Node.Server.Enabled": 1,
+    "DataStorm.Node.Server.Endpoints": "tcp -p 12345",
+    "DataStorm.Node.ConnectTo": ""
+}
+
+traceProps = {
+    "DataStorm.Trace.Topic" : 1,
+    "DataStorm.Trace.Session" : 1,
+    "DataStorm.Trace.Data" : 1
+}
+
+TestSuite(__file__, [
+    ClientServerTestCase(client=Writer(props=writerProps), server=Reader(props=readerProps), traceProps=traceProps)
+])
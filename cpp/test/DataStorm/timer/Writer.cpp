@@ -0,0 +1,295 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+#include <DataStorm/Admin.h>
+#include <DataStorm/DataStorm.h>
+
+#include <TestCommon.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace DataStorm;
+using namespace std;
+
+namespace
+{
+
+//
+// The node timer isn't part of the API, it's checked with the sample lifetime expiry of the writers: each writer
+// with samples arms a timer for the expiry of its oldest sample. The admin facet provides the number of timers
+// waiting to fire and the writer history depths.
+//
+class NodeObserver
+{
+public:
+
+    NodeObserver(const Node& node) :
+        _admin(dynamic_pointer_cast<NodeAdmin>(node.getCommunicator()->findAdminFacet("DataStorm.Admin")))
+    {
+        test(_admin);
+    }
+
+    long long int
+    getTimerQueueSize() const
+    {
+        return _admin->describe(Ice::emptyCurrent).timerQueueSize;
+    }
+
+    long long int
+    getHistoryDepth() const
+    {
+        long long int depth = 0;
+        for(const auto& topic : _admin->describe(Ice::emptyCurrent).topics)
+        {
+            for(const auto& element : topic.elements)
+            {
+                depth += element.historyDepth;
+            }
+        }
+        return depth;
+    }
+
+    chrono::milliseconds
+    waitForHistoryDepth(long long int depth, chrono::steady_clock::time_point start) const
+    {
+        auto timeout = chrono::steady_clock::now() + chrono::seconds(10);
+        while(getHistoryDepth() > depth)
+        {
+            test(chrono::steady_clock::now() < timeout);
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    }
+
+private:
+
+    const shared_ptr<NodeAdmin> _admin;
+};
+
+WriterConfig
+lifetimeConfig(int lifetime)
+{
+    return WriterConfig(-1, lifetime, ClearHistoryPolicy::Never);
+}
+
+void
+benchmark(Topic<int, string>& topic, const NodeObserver& observer, int timers, const string& output)
+{
+    mt19937 rng(static_cast<unsigned int>(timers));
+
+    //
+    // Each writer arms a timer when it publishes its first sample and cancels it when it's destroyed, the costs
+    // include the publication of the sample and the destruction of the writer.
+    //
+    cout << "testing schedule and cancel of " << timers << " timers... " << flush;
+    vector<SingleKeyWriter<int, string>> writers;
+    writers.reserve(static_cast<size_t>(timers));
+    for(int i = 0; i < timers; ++i)
+    {
+        writers.push_back(makeSingleKeyWriter(topic, i, "", lifetimeConfig(3600 * 1000)));
+    }
+    auto start = chrono::steady_clock::now();
+    for(auto& writer : writers)
+    {
+        writer.update("value");
+    }
+    auto elapsed = chrono::steady_clock::now() - start;
+    auto scheduleCost = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()) / timers;
+    test(observer.getTimerQueueSize() == timers);
+
+    start = chrono::steady_clock::now();
+    writers.clear();
+    elapsed = chrono::steady_clock::now() - start;
+    auto cancelCost = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()) / timers;
+    test(observer.getTimerQueueSize() == 0);
+    cout << "ok" << endl;
+
+    cout << "testing expiration of " << timers << " timers... " << flush;
+    uniform_int_distribution<int> lifetimes(0, 200);
+    for(int i = 0; i < timers; ++i)
+    {
+        writers.push_back(makeSingleKeyWriter(topic, i, "", lifetimeConfig(lifetimes(rng))));
+    }
+    start = chrono::steady_clock::now();
+    for(auto& writer : writers)
+    {
+        writer.update("value");
+    }
+    auto expiration = observer.waitForHistoryDepth(0, start);
+    test(observer.getTimerQueueSize() == 0);
+    writers.clear();
+    cout << "ok" << endl;
+
+    cout << fixed << setprecision(1) << "schedule " << scheduleCost << "ns/timer, cancel " << cancelCost
+         << "ns/timer, expired " << timers << " timers in " << expiration.count() << "ms" << endl;
+
+    if(!output.empty())
+    {
+        ofstream out(output, ios::app);
+        out << fixed << setprecision(1)
+            << "{\"timers\": " << timers
+            << ", \"scheduleNs\": " << scheduleCost
+            << ", \"cancelNs\": " << cancelCost
+            << ", \"elapsedMs\": " << expiration.count() << "}" << endl;
+    }
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    int timers = 0;
+    string output;
+    for(int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        auto pos = arg.find('=');
+        if(arg.compare(0, pos, "--timers") == 0 && pos != string::npos)
+        {
+            timers = stoi(arg.substr(pos + 1));
+        }
+        else if(arg.compare(0, pos, "--output") == 0 && pos != string::npos)
+        {
+            output = arg.substr(pos + 1);
+        }
+    }
+
+    //
+    // The node doesn't connect to other nodes, the only timers are the expiry timers of the writers.
+    //
+    Ice::InitializationData initData;
+    initData.properties = Ice::createProperties(argc, argv);
+    initData.properties->setProperty("DataStorm.Node.Admin.Enabled", "1");
+    initData.properties->setProperty("DataStorm.Node.Multicast.Enabled", "0");
+    initData.properties->setProperty("DataStorm.Node.Server.Enabled", "0");
+    initData.properties->setProperty("DataStorm.Node.ConnectTo", "");
+    Ice::CommunicatorHolder holder(initData);
+    Node node(holder.communicator());
+    NodeObserver observer(node);
+
+    Topic<int, string> topic(node, "topic");
+
+    cout << "testing timer expiration... " << flush;
+    {
+        auto writer = makeSingleKeyWriter(topic, 0, "", lifetimeConfig(100));
+        test(observer.getTimerQueueSize() == 0);
+        auto start = chrono::steady_clock::now();
+        writer.update("value");
+        test(observer.getTimerQueueSize() == 1);
+        test(observer.getHistoryDepth() == 1);
+        test(observer.waitForHistoryDepth(0, start) >= chrono::milliseconds(99)); // Timers never fire early
+        test(observer.getTimerQueueSize() == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing timer cancel... " << flush;
+    {
+        {
+            vector<SingleKeyWriter<int, string>> writers;
+            for(int i = 0; i < 100; ++i)
+            {
+                writers.push_back(makeSingleKeyWriter(topic, i, "", lifetimeConfig(10 * 1000)));
+                writers.back().update("value");
+            }
+            test(observer.getTimerQueueSize() == 100);
+
+            // Destroying the writers cancels their timers.
+            writers.erase(writers.begin(), writers.begin() + 50);
+            test(observer.getTimerQueueSize() == 50);
+        }
+        test(observer.getTimerQueueSize() == 0);
+
+        //
+        // The entry of a canceled timer is reused by the next timer, the canceled timer must not expire the
+        // samples of the writer which armed the new timer.
+        //
+        auto writer = makeSingleKeyWriter(topic, 0, "", lifetimeConfig(50));
+        {
+            auto canceled = makeSingleKeyWriter(topic, 1, "", lifetimeConfig(20));
+            canceled.update("value");
+        }
+        auto start = chrono::steady_clock::now();
+        writer.update("value");
+        test(observer.getTimerQueueSize() == 1);
+        test(observer.waitForHistoryDepth(0, start) >= chrono::milliseconds(49));
+        test(observer.getTimerQueueSize() == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing timer reschedule... " << flush;
+    {
+        //
+        // The timer of a writer is armed for its oldest sample and armed again for the next oldest sample once it
+        // fires.
+        //
+        auto writer = makeSingleKeyWriter(topic, 0, "", lifetimeConfig(200));
+        auto start = chrono::steady_clock::now();
+        writer.update("value1");
+        this_thread::sleep_for(chrono::milliseconds(100));
+        writer.update("value2");
+        test(observer.getTimerQueueSize() == 1);
+        test(observer.getHistoryDepth() == 2);
+        test(observer.waitForHistoryDepth(1, start) >= chrono::milliseconds(199));
+        test(observer.getTimerQueueSize() == 1);
+        test(observer.waitForHistoryDepth(0, start) >= chrono::milliseconds(299));
+        test(observer.getTimerQueueSize() == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing timer cascade... " << flush;
+    {
+        //
+        // The wheel has 256 slots of 1ms per level, the timers of 256ms and more are stored in the upper levels and
+        // cascaded to the lower level before they fire. They must fire in order and never early.
+        //
+        vector<int> lifetimes = { 1000, 600, 50, 300, 257, 255 };
+        vector<SingleKeyWriter<int, string>> writers;
+        for(size_t i = 0; i < lifetimes.size(); ++i)
+        {
+            writers.push_back(makeSingleKeyWriter(topic, static_cast<int>(i), "", lifetimeConfig(lifetimes[i])));
+        }
+        auto start = chrono::steady_clock::now();
+        for(auto& writer : writers)
+        {
+            writer.update("value");
+        }
+        test(observer.getTimerQueueSize() == static_cast<long long int>(lifetimes.size()));
+
+        sort(lifetimes.begin(), lifetimes.end());
+        auto depth = static_cast<long long int>(lifetimes.size());
+        for(auto lifetime : lifetimes)
+        {
+            test(observer.waitForHistoryDepth(--depth, start) >= chrono::milliseconds(lifetime - 1));
+        }
+        test(observer.getTimerQueueSize() == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing timer schedule after idle... " << flush;
+    {
+        //
+        // The timer thread doesn't move the wheel while it's empty, a timer scheduled after the wheel has been
+        // idle for longer than a level must still be inserted relative to the current time.
+        //
+        test(observer.getTimerQueueSize() == 0);
+        this_thread::sleep_for(chrono::milliseconds(600));
+        auto writer = makeSingleKeyWriter(topic, 0, "", lifetimeConfig(20));
+        auto start = chrono::steady_clock::now();
+        writer.update("value");
+        auto expiration = observer.waitForHistoryDepth(0, start);
+        test(expiration >= chrono::milliseconds(19) && expiration < chrono::seconds(1));
+        test(observer.getTimerQueueSize() == 0);
+    }
+    cout << "ok" << endl;
+
+    if(timers > 0)
+    {
+        benchmark(topic, observer, timers, output);
+    }
+    return 0;
+}
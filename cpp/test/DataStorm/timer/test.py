@@ -0,0 +1,35 @@
+# **********************************************************************
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+# **********************************************************************
+
+#
+# Checks the expiration, cancel, reschedule and cascade of the node timers with the sample lifetime expiry of the
+# writers. With the --benchmarks option, the cost of scheduling, canceling and firing timers is also measured and
+# the results of each configuration are appended as a JSON object to the results.json file of the writer build
+# directory or to the file of the --benchmark-output directory.
+#
+class TimerTestSuite(TestSuite):
+
+    def setup(self, current):
+        TestSuite.setup(self, current)
+        output = component.getBenchmarkOutput(self, current)
+        if output:
+            if not os.path.exists(os.path.dirname(output)):
+                os.makedirs(os.path.dirname(output))
+            elif os.path.exists(output):
+                os.remove(output)
+
+def options(timers):
+    def getArgs(process, current):
+        output = component.getBenchmarkOutput(current.testsuite, current)
+        return ["--timers={0}".format(timers)] + (["--output={0}".format(output)] if output else [])
+    return getArgs
+
+testcases = [ClientTestCase()]
+if component.benchmarks:
+    testcases += [ClientTestCase(name="timers={0}".format(timers), client=Writer(args=options(timers)))
+                  for timers in [1000, 10000]]
+
+TimerTestSuite(__file__, testcases)
@@ -25,6 +25,18 @@ enum class color : unsigned char
     red,
 };
 
+struct Tick
+{
+    int id;
+    double price;
+};
+
+bool
+operator==(const Tick& lhs, const Tick& rhs)
+{
+    return lhs.id == rhs.id && lhs.price == rhs.price;
+}
+
 template<typename T> bool compare(T v1, T v2)
 {
     return v1 == v2;
@@ -63,6 +75,10 @@ testReader(T topic, A add, U update)
 namespace DataStorm
 {
 
+template<> struct TrivialEncoding<Tick> : true_type
+{
+};
+
 template<> struct Decoder<color>
 {
     static color
@@ -118,5 +134,8 @@ main(int argc, char* argv[])
     testReader(Topic<color, string>(node, "enumstring"),
                map<color, string> { { color::blue, "v1" }, { color::red, "v2" } },
                map<color, string> { { color::blue, "u1" }, { color::red, "u2" } });
+    testReader(Topic<int, Tick>(node, "inttrivialstruct"),
+               map<int, Tick> { { 1, { 1, 2.0 } }, { 2, { 2, 8.7 } } },
+               map<int, Tick> { { 1, { 1, 4.0 } }, { 2, { 2, 7.8 } } });
     return 0;
 }
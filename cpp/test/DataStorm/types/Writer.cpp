@@ -19,6 +19,12 @@ enum class color : unsigned char
     red,
 };
 
+struct Tick
+{
+    int id;
+    double price;
+};
+
 template<typename T, typename A, typename U> void
 testWriter(T topic, A add, U update)
 {
@@ -50,6 +56,10 @@ testWriter(T topic, A add, U update)
 namespace DataStorm
 {
 
+template<> struct TrivialEncoding<Tick> : true_type
+{
+};
+
 template<> struct Decoder<color>
 {
     static color
@@ -127,5 +137,11 @@ main(int argc, char* argv[])
                map<color, string> { { color::blue, "u1" }, { color::red, "u2" } });
     cout << "ok" << endl;
 
+    cout << "testing int/trivial struct... " << flush;
+    testWriter(Topic<int, Tick>(node, "inttrivialstruct"),
+               map<int, Tick> { { 1, { 1, 2.0 } }, { 2, { 2, 8.7 } } },
+               map<int, Tick> { { 1, { 1, 4.0 } }, { 2, { 2, 7.8 } } });
+    cout << "ok" << endl;
+
     return 0;
 }
@@ -27,6 +27,11 @@ class Node(ProcessFromBinDir, Server):
         props['Ice.ProgramName'] = self.desc
         return props
 
+class Recorder(ProcessFromBinDir, SimpleClient):
+    def __init__(self, desc=None, **kargs):
+        SimpleClient.__init__(self, "dsrecorder", mapping=Mapping.getByName("cpp"),
+                              desc=desc or "DataStorm flight recorder", quiet=True, **kargs)
+
 class NodeTestCase(ClientServerTestCase):
 
     def __init__(self, nodes=None, nodeProps=None, *args, **kargs):
@@ -69,6 +74,8 @@ class DataStorm(Component):
     def __init__(self):
         Component.__init__(self)
         self.multicast = False
+        self.benchmarks = False
+        self.benchmarkOutput = ""
 
     def useBinDist(self, mapping, current):
         return Component._useBinDist(self, mapping, current, "DATASTORM_BIN_DIST")
@@ -78,19 +85,33 @@ class DataStorm(Component):
         envHomeName = None if isinstance(platform, Windows) else "DATASTORM_HOME"
         return Component._getInstallDir(self, mapping, current, envHomeName)
 
+    def getBenchmarkOutput(self, testsuite, current):
+        # The benchmark results are written to the given output directory or, with --benchmarks, to the results.json
+        # file of the writer build directory. They are not written otherwise.
+        if self.benchmarkOutput:
+            return os.path.join(os.path.abspath(self.benchmarkOutput), testsuite.getId().replace("/", "_") + ".json")
+        elif self.benchmarks:
+            return os.path.join(testsuite.getPath(), testsuite.getMapping().getBuildDir("writer", current),
+                                "results.json")
+        return None
+
     def getOptions(self, testcase, current):
         return { "multicast": [False, True] }
 
     def getSupportedArgs(self):
-        return ("", ["multicast"])
+        return ("", ["multicast", "benchmarks", "benchmark-output="])
 
     def usage(self):
         print("")
         print("DataStorm options:")
         print("--multicast           Run with multicast discovery.")
+        print("--benchmarks          Run the benchmarks and the large scale tests.")
+        print("--benchmark-output=<dir> Run the benchmarks and write their results to the given directory.")
 
     def parseOptions(self, options):
-        parseOptions(self, options)
+        parseOptions(self, options, { "benchmark-output" : "benchmarkOutput" })
+        if self.benchmarkOutput:
+            self.benchmarks = True
 
     def getProps(self, process, current):
         if self.multicast: